@@ -0,0 +1,144 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/TapeProcessor.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Compares the anti-aliasing paths on aliasing against CPU: first and second
+// order ADAA at 1x, and the 2x and 4x oversampling of the Standard and HQ
+// tiers. A driven sine lands on an exact analysis bin, so its harmonics below
+// Nyquist do too; whatever energy falls between them is folded back from
+// above Nyquist. Type II, whose curve is memoryless, takes every path
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int analysisLength = 16384;
+    constexpr int settleSamples = 48000;
+    constexpr int timedSamples = 480000;
+
+    struct Path
+    {
+        const char* name;
+        QualityMode quality;
+        AntialiasingMode antialiasing;
+    };
+
+    const Path paths[] = {
+        { "1x, no AA (Eco)",      QualityMode::Eco,      AntialiasingMode::Oversampling },
+        { "ADAA1 (Eco)",          QualityMode::Eco,      AntialiasingMode::ADAA1 },
+        { "ADAA2 (Eco)",          QualityMode::Eco,      AntialiasingMode::ADAA2 },
+        { "ADAA1 (Standard)",     QualityMode::Standard, AntialiasingMode::ADAA1 },
+        { "ADAA2 (Standard)",     QualityMode::Standard, AntialiasingMode::ADAA2 },
+        { "2x (Standard)",        QualityMode::Standard, AntialiasingMode::Oversampling },
+        { "4x (HQ)",              QualityMode::HQ,       AntialiasingMode::Oversampling },
+    };
+
+    // Fundamentals, as analysis bins: about 3, 7 and 11 kHz, none dividing the
+    // length, so no folded harmonic lands back on a harmonic bin
+    const int fundamentalBins[] = { 1021, 2389, 3755 };
+
+    void configure(TapeProcessor& processor, const Path& path)
+    {
+        processor.setQuality(static_cast<int>(path.quality));
+        processor.setAntialiasing(static_cast<int>(path.antialiasing));
+        processor.setTapeType(static_cast<int>(TapeType::TypeII));
+        processor.setInputDrive(12.0f);
+        processor.setSaturation(100.0f);
+        processor.setWow(0.0f);
+        processor.setFlutter(0.0f);
+        processor.setHiss(0.0f);
+        processor.setMix(100.0f);
+        processor.prepare(sampleRate, blockSize);
+    }
+
+    // Runs a sine through the processor, a block at a time, into output
+    void render(TapeProcessor& processor, int bin, int64_t startSample, std::vector<float>& output)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        const double phaseIncrement = juce::MathConstants<double>::twoPi * bin / analysisLength;
+
+        for (size_t done = 0; done < output.size(); done += blockSize)
+        {
+            const int numSamples = static_cast<int>(std::min<size_t>(blockSize, output.size() - done));
+            buffer.setSize(2, numSamples, false, false, true);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto sample = static_cast<float>(0.5 * std::sin(phaseIncrement * static_cast<double>(startSample + (int64_t) done + i)));
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+            }
+
+            processor.process(buffer);
+            std::copy(buffer.getReadPointer(0), buffer.getReadPointer(0) + numSamples, output.begin() + (std::ptrdiff_t) done);
+        }
+    }
+
+    double binEnergy(const std::vector<float>& signal, int bin)
+    {
+        double re = 0.0, im = 0.0;
+        const double increment = juce::MathConstants<double>::twoPi * bin / analysisLength;
+        for (int i = 0; i < analysisLength; ++i)
+        {
+            re += signal[(size_t) i] * std::cos(increment * i);
+            im += signal[(size_t) i] * std::sin(increment * i);
+        }
+        return (bin == 0 ? 1.0 : 2.0) * (re * re + im * im) / analysisLength;
+    }
+
+    // Energy outside DC and the harmonics below Nyquist, relative to the total
+    double aliasingDb(TapeProcessor& processor, int bin)
+    {
+        std::vector<float> settle((size_t) settleSamples);
+        render(processor, bin, 0, settle);
+
+        std::vector<float> signal((size_t) analysisLength);
+        render(processor, bin, settleSamples, signal);
+
+        double total = 0.0;
+        for (float sample : signal)
+            total += static_cast<double>(sample) * sample;
+
+        double harmonics = binEnergy(signal, 0);
+        for (int harmonic = bin; harmonic < analysisLength / 2; harmonic += bin)
+            harmonics += binEnergy(signal, harmonic);
+
+        const double aliased = std::max(total - harmonics, total * 1.0e-15);
+        return 10.0 * std::log10(aliased / total);
+    }
+
+    double nanosecondsPerSample(TapeProcessor& processor)
+    {
+        std::vector<float> output((size_t) timedSamples);
+        const auto start = std::chrono::steady_clock::now();
+        render(processor, fundamentalBins[1], 0, output);
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / timedSamples;
+    }
+}
+
+int main()
+{
+    std::printf("%-18s %9s %9s %9s %12s %8s\n", "Path", "3 kHz", "7 kHz", "11 kHz", "ns/sample", "latency");
+
+    for (const auto& path : paths)
+    {
+        std::printf("%-18s", path.name);
+
+        for (int bin : fundamentalBins)
+        {
+            TapeProcessor processor;
+            configure(processor, path);
+            std::printf(" %6.1f dB", aliasingDb(processor, bin));
+        }
+
+        TapeProcessor processor;
+        configure(processor, path);
+        std::printf(" %12.1f %8d\n", nanosecondsPerSample(processor), processor.getLatencySamples());
+    }
+
+    std::printf("Aliasing is the energy between the harmonics, relative to the whole output\n");
+    return 0;
+}
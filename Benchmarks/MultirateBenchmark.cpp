@@ -0,0 +1,178 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/TapeProcessor.h"
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+// Whether running the low-frequency stages on a decimated band would pay
+// off at high host rates. The chain is timed with the head bump and
+// wow/flutter on and off: the difference is all a multirate path could
+// save. The head bump is then timed at full rate and as the decimated path
+// would run it (boxcar decimation to 44.1/48 kHz, the biquad on the
+// boost at the low rate, linear interpolation back). Wow/flutter's
+// modulation is only generated once per control tick, so decimating it
+// saves nothing measurable; its delay line is full-band and stays at full
+// rate. Last, the bump's gain at its centre from the single-precision
+// coefficients, against the design, shows what the full-rate biquad loses
+// at high rates
+namespace
+{
+    constexpr int blockSize = 512;
+    constexpr double timedSeconds = 4.0;
+    constexpr int repeats = 3;
+    constexpr float bumpFrequency = 40.0f;      // Lowest Bump Freq, where the poles sit closest to DC
+    constexpr float headBump = 1.0f;
+
+    const TapeModel& getModel()
+    {
+        return TapeCharacteristics::builtInModels.get(MachineType::IPS_7_5, TapeType::TypeI, QualityMode::Standard);
+    }
+
+    // Best of several runs, so a descheduled run does not count
+    template <typename Function>
+    double bestNanosecondsPerSample(int64_t numSamples, Function&& function)
+    {
+        double best = 1.0e30;
+        for (int r = 0; r < repeats; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, elapsed / static_cast<double>(numSamples));
+        }
+        return best;
+    }
+
+    double chainNanosecondsPerSample(double sampleRate, bool lowFrequencyStages)
+    {
+        const int numBlocks = static_cast<int>(sampleRate * timedSeconds) / blockSize;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+
+        return bestNanosecondsPerSample(static_cast<int64_t>(numBlocks) * blockSize, [&]
+        {
+            TapeProcessor processor;
+            processor.setMachineType(static_cast<int>(MachineType::IPS_7_5));
+            processor.setBumpFreq(bumpFrequency);
+            processor.setHeadBump(lowFrequencyStages ? 60.0f : 0.0f);
+            processor.setWow(lowFrequencyStages ? 50.0f : 0.0f);
+            processor.setFlutter(lowFrequencyStages ? 40.0f : 0.0f);
+            processor.setHiss(0.0f);
+            processor.prepare(sampleRate, blockSize);
+
+            juce::Random random(1);
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample(ch, i, random.nextFloat() - 0.5f);
+
+                processor.process(buffer);
+            }
+        });
+    }
+
+    // Largest power of two that keeps the low band at 44.1 kHz or above
+    int getDecimation(double sampleRate)
+    {
+        int factor = 1;
+        while (factor < 4 && sampleRate / (factor * 2) >= 44100.0)
+            factor *= 2;
+        return factor;
+    }
+
+    double fullRateBumpNanosecondsPerSample(double sampleRate, std::vector<float>& data)
+    {
+        const auto& kernels = TapeKernels::selectKernels();
+        const auto coeffs = TapeProcessor::calculateHeadBumpCoefficients(getModel(), bumpFrequency, headBump, sampleRate);
+        TapeKernels::BiquadState state;
+        const int numBlocks = static_cast<int>(data.size()) / blockSize;
+
+        return bestNanosecondsPerSample(static_cast<int64_t>(data.size()), [&]
+        {
+            for (int b = 0; b < numBlocks; ++b)
+                kernels.biquad(data.data() + b * blockSize, blockSize, coeffs, state);
+        });
+    }
+
+    double decimatedBumpNanosecondsPerSample(double sampleRate, std::vector<float>& data)
+    {
+        const int factor = getDecimation(sampleRate);
+        const float scale = 1.0f / static_cast<float>(factor);
+
+        // Boost only: the filter's output minus its input
+        auto coeffs = TapeProcessor::calculateHeadBumpCoefficients(getModel(), bumpFrequency, headBump, sampleRate / factor);
+        coeffs.b0 -= 1.0f;
+        coeffs.b1 -= coeffs.a1;
+        coeffs.b2 -= coeffs.a2;
+
+        TapeKernels::BiquadState state;
+        double previous = 0.0, current = 0.0;
+        float sum = 0.0f;
+        int phase = 0;
+
+        return bestNanosecondsPerSample(static_cast<int64_t>(data.size()), [&]
+        {
+            for (auto& sample : data)
+            {
+                sum += sample;
+                sample += static_cast<float>(previous + (current - previous) * (phase + 1) * scale);
+
+                if (++phase == factor)
+                {
+                    const double x = sum * scale;
+                    const double y = coeffs.b0 * x + coeffs.b1 * state.x1 + coeffs.b2 * state.x2
+                                   - coeffs.a1 * state.y1 - coeffs.a2 * state.y2;
+                    state = { x, state.x1, y, state.y1 };
+                    previous = current;
+                    current = y;
+                    sum = 0.0f;
+                    phase = 0;
+                }
+            }
+        });
+    }
+
+    // Gain at the bump's centre of the coefficients as rounded to float,
+    // against the gain they were designed for
+    double bumpGainErrorDb(double sampleRate)
+    {
+        const auto& model = getModel();
+        const auto coeffs = TapeProcessor::calculateHeadBumpCoefficients(model, bumpFrequency, headBump, sampleRate);
+        const double centre = std::clamp(bumpFrequency * model.bumpSpeedMultiplier, 30.0f, 200.0f);
+
+        const auto z = std::polar(1.0, -juce::MathConstants<double>::twoPi * centre / sampleRate);
+        const auto polynomial = [z](double c0, double c1, double c2) { return c0 + (c1 + c2 * z) * z; };
+        const auto response = polynomial(coeffs.b0, coeffs.b1, coeffs.b2) / polynomial(1.0, coeffs.a1, coeffs.a2);
+        return 20.0 * std::log10(std::abs(response)) - headBump * model.bumpMaxGainDb;
+    }
+}
+
+int main()
+{
+    std::printf("%-8s %12s %12s %10s %5s %12s %12s %12s %12s\n", "Rate", "Chain", "Chain, no LF", "LF share",
+                "Dec", "Bump, full", "Bump, dec", "Bump err", "Bump err dec");
+
+    for (double sampleRate : { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 })
+    {
+        const double withLowFrequency = chainNanosecondsPerSample(sampleRate, true);
+        const double withoutLowFrequency = chainNanosecondsPerSample(sampleRate, false);
+
+        std::vector<float> data(static_cast<size_t>(sampleRate * timedSeconds) / blockSize * blockSize);
+        juce::Random random(2);
+        for (auto& sample : data)
+            sample = random.nextFloat() - 0.5f;
+
+        const int factor = getDecimation(sampleRate);
+        const double fullRate = fullRateBumpNanosecondsPerSample(sampleRate, data);
+        const double decimated = decimatedBumpNanosecondsPerSample(sampleRate, data);
+
+        std::printf("%-8.0f %9.1f ns %9.1f ns %9.1f%% %4dx %9.2f ns %9.2f ns %9.3f dB %9.3f dB\n", sampleRate,
+                    withLowFrequency, withoutLowFrequency,
+                    100.0 * (withLowFrequency - withoutLowFrequency) / withLowFrequency, factor,
+                    fullRate, decimated, bumpGainErrorDb(sampleRate), bumpGainErrorDb(sampleRate / factor));
+    }
+
+    std::printf("LF share is the most a multirate path could save; it would still pay the decimated bump's cost\n");
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/TapeProcessor.h"
+#include <chrono>
+#include <cstdio>
+
+// Times the two machine response modes against each other: the head bump
+// biquad in the filter cascade, and the partitioned convolution with the
+// machine's full response. Every other optional stage is off, so the
+// difference from the run with no head bump is the response's own cost.
+// With no head bump the convolution is skipped, so it costs the same as
+// the filters
+namespace
+{
+    constexpr int blockSize = 256;
+    constexpr double timedSeconds = 10.0;
+
+    double nanosecondsPerSample(double sampleRate, ResponseMode mode, float headBump)
+    {
+        TapeProcessor processor;
+        processor.setResponseMode(static_cast<int>(mode));
+        processor.setHeadBump(headBump);
+        processor.setWow(0.0f);
+        processor.setFlutter(0.0f);
+        processor.setHiss(0.0f);
+        processor.prepare(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::Random random(1);
+        const int numBlocks = static_cast<int>(sampleRate * timedSeconds) / blockSize;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, random.nextFloat() - 0.5f);
+
+            processor.process(buffer);
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / (static_cast<double>(numBlocks) * blockSize);
+    }
+}
+
+int main()
+{
+    std::printf("%-10s %14s %14s %14s %14s\n", "Rate", "No head bump", "Biquad", "Convolution", "Conv, skipped");
+
+    for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+    {
+        const double none = nanosecondsPerSample(sampleRate, ResponseMode::Filters, 0.0f);
+        const double biquad = nanosecondsPerSample(sampleRate, ResponseMode::Filters, 60.0f);
+        const double convolution = nanosecondsPerSample(sampleRate, ResponseMode::Convolution, 60.0f);
+        const double skipped = nanosecondsPerSample(sampleRate, ResponseMode::Convolution, 0.0f);
+
+        std::printf("%-10.0f %11.1f ns %11.1f ns %11.1f ns %11.1f ns   (biquad %+.1f, convolution %+.1f ns/sample)\n",
+                    sampleRate, none, biquad, convolution, skipped, biquad - none, convolution - none);
+    }
+
+    return 0;
+}
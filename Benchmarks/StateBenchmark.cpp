@@ -0,0 +1,136 @@
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+
+// Times what opening a session with many instances costs: constructing and
+// preparing them, opening editors, and saving and loading their state in the
+// binary format and in the APVTS XML it replaced. Also checks that the binary
+// state round-trips and that truncated copies of it are rejected
+namespace
+{
+    constexpr int numInstances = 500;
+    constexpr int numEditors = 20;
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::vector<float> getValues(juce::AudioProcessor& processor)
+    {
+        std::vector<float> values;
+        for (auto* parameter : processor.getParameters())
+            values.push_back(parameter->getValue());
+        return values;
+    }
+
+    size_t totalSize(const std::vector<juce::MemoryBlock>& blocks)
+    {
+        return std::accumulate(blocks.begin(), blocks.end(), size_t { 0 },
+                               [](size_t sum, const juce::MemoryBlock& block) { return sum + block.getSize(); });
+    }
+
+    void report(const char* name, double milliseconds, size_t bytes)
+    {
+        std::printf("%-14s %8.2f ms total  %7.2f us/instance", name, milliseconds, milliseconds * 1000.0 / numInstances);
+        if (bytes > 0)
+            std::printf("  %6zu bytes/instance", bytes / numInstances);
+        std::printf("\n");
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::vector<std::unique_ptr<TapeWarmAudioProcessor>> instances;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numInstances; ++i)
+        instances.push_back(std::make_unique<TapeWarmAudioProcessor>());
+    report("Construct", millisecondsSince(start), 0);
+
+    start = std::chrono::steady_clock::now();
+    for (auto& instance : instances)
+        instance->prepareToPlay(48000.0, 512);
+    report("First prepare", millisecondsSince(start), 0);
+
+    // The first editor decodes the background image; later ones reuse it
+    for (int i = 0; i < numEditors; ++i)
+    {
+        start = std::chrono::steady_clock::now();
+        std::unique_ptr<juce::AudioProcessorEditor> editor(instances[(size_t) i]->createEditor());
+        const double milliseconds = millisecondsSince(start);
+
+        if (i == 0 || i == numEditors - 1)
+            std::printf("%-14s %8.2f ms (editor %d)\n", "Editor open", milliseconds, i + 1);
+    }
+
+    juce::Random random(1);
+    for (auto& instance : instances)
+        for (auto* parameter : instance->getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+
+    // Non-parameter state, which the binary format has to carry too
+    instances.front()->getAPVTS().state.setProperty("note", "kept", nullptr);
+
+    std::vector<std::vector<float>> expected;
+    for (auto& instance : instances)
+        expected.push_back(getValues(*instance));
+
+    std::vector<juce::MemoryBlock> binary(numInstances), xml(numInstances);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numInstances; ++i)
+        instances[(size_t) i]->getStateInformation(binary[(size_t) i]);
+    report("Binary save", millisecondsSince(start), totalSize(binary));
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numInstances; ++i)
+        juce::AudioProcessor::copyXmlToBinary(*instances[(size_t) i]->getAPVTS().copyState().createXml(), xml[(size_t) i]);
+    report("XML save", millisecondsSince(start), totalSize(xml));
+
+    int failures = 0;
+
+    const auto loadAll = [&](const char* name, const std::vector<juce::MemoryBlock>& blocks)
+    {
+        for (auto& instance : instances)
+        {
+            for (auto* parameter : instance->getParameters())
+                parameter->setValueNotifyingHost(parameter->getDefaultValue());
+            instance->getAPVTS().state.removeProperty("note", nullptr);
+        }
+
+        const auto loadStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < numInstances; ++i)
+            instances[(size_t) i]->setStateInformation(blocks[(size_t) i].getData(), (int) blocks[(size_t) i].getSize());
+        report(name, millisecondsSince(loadStart), totalSize(blocks));
+
+        for (int i = 0; i < numInstances; ++i)
+            if (getValues(*instances[(size_t) i]) != expected[(size_t) i])
+                ++failures;
+
+        if (instances.front()->getAPVTS().state.getProperty("note") != juce::var("kept"))
+            ++failures;
+    };
+
+    loadAll("Binary load", binary);
+    loadAll("XML load", xml);
+
+    // Every truncation of a saved state leaves the loaded values untouched
+    auto& instance = *instances.back();
+    const auto& saved = binary.back();
+    const auto before = getValues(instance);
+
+    for (size_t length = 12; length < saved.getSize(); ++length)
+    {
+        instance.setStateInformation(saved.getData(), (int) length);
+        if (getValues(instance) != before)
+            ++failures;
+    }
+
+    std::printf("%s (%d failures)\n", failures == 0 ? "Round trip and truncation checks passed" : "Checks FAILED", failures);
+    return failures == 0 ? 0 : 1;
+}
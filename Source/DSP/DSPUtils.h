@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <random>
 
 namespace DSPUtils
@@ -26,21 +30,185 @@ namespace DSPUtils
         return std::tanh(sample);
     }
 
-    // Tape-style soft clipping with even harmonics
-    inline float tapeSaturate(float sample, float drive)
+    // Rational (Pade) tanh approximation, clamped where it reaches +-1
+    inline float fastTanh(float x)
     {
-        // Asymmetric soft clipping for even harmonics
-        float x = sample * drive;
-        float y = std::tanh(x);
+        if (x > 3.0f) return 1.0f;
+        if (x < -3.0f) return -1.0f;
+        float x2 = x * x;
+        return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    }
+
+    // Branch-free rational tanh accurate to float precision (13/6 minimax,
+    // max error ~3e-8), so block kernels can vectorise it
+    inline float accurateTanh(float x)
+    {
+        x = std::clamp(x, -9.0f, 9.0f);
+        float x2 = x * x;
+
+        float p = -2.76076847742355e-16f;
+        p = p * x2 + 2.00018790482477e-13f;
+        p = p * x2 - 8.60467152213735e-11f;
+        p = p * x2 + 5.12229709037114e-08f;
+        p = p * x2 + 1.48572235717979e-05f;
+        p = p * x2 + 6.37261928875436e-04f;
+        p = p * x2 + 4.89352455891786e-03f;
+
+        float q = 1.19825839466702e-06f;
+        q = q * x2 + 1.18534705686654e-04f;
+        q = q * x2 + 2.26843463243900e-03f;
+        q = q * x2 + 4.89352518554385e-03f;
+
+        return x * p / q;
+    }
+
+    //==============================================================================
+    // Antiderivative anti-aliasing (ADAA) of memoryless curves: the output is
+    // the curve's antiderivative differenced over the input step, which
+    // suppresses aliasing without oversampling. First order adds half a
+    // sample of delay, second order one sample. Antiderivatives are
+    // evaluated in double precision since their differences are divided by
+    // small input steps.
+
+    // ln(cosh x), the first antiderivative of tanh, without overflow
+    inline double logCosh(double x)
+    {
+        const double magnitude = std::abs(x);
+        return magnitude + std::log1p(std::exp(-2.0 * magnitude)) - 0.69314718055994531;
+    }
+
+    // Integral of ln(cosh t) from 0 to x, the second antiderivative of tanh.
+    // For x >= 0 it is x^2/2 - x ln2 + Li2(-e^-2x)/2 + pi^2/24 (odd overall).
+    // With u = ln(1 + e^-2x), Li2(-e^-2x) = -Li2(1 - e^-u) - u^2/2, and the
+    // Bernoulli series of Li2(1 - e^-u) converges fast for u <= ln2
+    inline double tanhAntiderivative2(double x)
+    {
+        const double magnitude = std::abs(x);
+        const double u = std::log1p(std::exp(-2.0 * magnitude));
+        const double u2 = u * u;
+
+        double odd = 8.921691020456452e-13;
+        odd = odd * u2 - 4.0647616451442256e-11;
+        odd = odd * u2 + 1.8978869988971e-09;
+        odd = odd * u2 - 9.185773074661964e-08;
+        odd = odd * u2 + 4.72411186696901e-06;
+        odd = odd * u2 - 2.777777777777778e-04;
+        odd = odd * u2 + 2.777777777777778e-02;
+        odd = odd * u2 + 1.0;
 
-        // Add slight asymmetry for even harmonics
-        float asymmetry = 0.1f * drive;
-        if (x > 0.0f)
-            y *= (1.0f + asymmetry * 0.5f);
+        const double dilog = -(u * odd - 0.25 * u2) - 0.5 * u2;
+        const double result = 0.5 * magnitude * magnitude - 0.69314718055994531 * magnitude
+                            + 0.5 * dilog + 0.41123351671205660;
+        return x < 0.0 ? -result : result;
+    }
+
+    // tanh(x)
+    struct TanhCurve
+    {
+        double value(double x) const { return std::tanh(x); }
+        double antiderivative1(double x) const { return logCosh(x); }
+        double antiderivative2(double x) const { return tanhAntiderivative2(x); }
+    };
+
+    // Linear up to 0.7, tanh knee above (Modern tape)
+    struct SoftKneeCurve
+    {
+        static constexpr double knee = 0.7;
+
+        double value(double x) const
+        {
+            const double excess = std::abs(x) - knee;
+            return excess > 0.0 ? std::copysign(knee + 0.3 * std::tanh(2.0 * excess), x) : x;
+        }
+
+        double antiderivative1(double x) const
+        {
+            const double excess = std::abs(x) - knee;
+            if (excess <= 0.0)
+                return 0.5 * x * x;
+
+            return 0.5 * knee * knee + knee * excess + 0.15 * logCosh(2.0 * excess);
+        }
+
+        double antiderivative2(double x) const
+        {
+            const double excess = std::abs(x) - knee;
+            if (excess <= 0.0)
+                return x * x * x / 6.0;
+
+            const double magnitude = knee * knee * knee / 6.0 + 0.5 * knee * knee * excess
+                                   + 0.5 * knee * excess * excess + 0.075 * tanhAntiderivative2(2.0 * excess);
+            return std::copysign(magnitude, x);
+        }
+    };
+
+    // Input history of one channel, for adaa1() or adaa2()
+    struct AntiderivativeState
+    {
+        double x1 = 0.0;                // Previous input
+        double x2 = 0.0;                // Input before that (second order)
+        double antiderivative = 0.0;    // F1 (first order) or F2 (second order) at x1
+        double difference = 0.0;        // Second order: divided difference of F2 over [x2, x1]
+    };
+
+    // Below this input step the divided differences are ill-conditioned and
+    // their limits are used instead
+    constexpr double ADAA_TOLERANCE = 1.0e-5;
+
+    template <typename Curve>
+    inline float adaa1(const Curve& curve, float input, AntiderivativeState& state)
+    {
+        const double x = input;
+        const double antiderivative = curve.antiderivative1(x);
+        const double delta = x - state.x1;
+
+        double y;
+        if (std::abs(delta) < ADAA_TOLERANCE)
+            y = curve.value(0.5 * (x + state.x1));
         else
-            y *= (1.0f - asymmetry * 0.3f);
+            y = (antiderivative - state.antiderivative) / delta;
 
-        return y;
+        state.x1 = x;
+        state.antiderivative = antiderivative;
+        return static_cast<float>(y);
+    }
+
+    template <typename Curve>
+    inline float adaa2(const Curve& curve, float input, AntiderivativeState& state)
+    {
+        const double x = input;
+        const double antiderivative = curve.antiderivative2(x);
+        const double delta = x - state.x1;
+
+        const double difference = (std::abs(delta) < ADAA_TOLERANCE)
+                                ? curve.antiderivative1(0.5 * (x + state.x1))
+                                : (antiderivative - state.antiderivative) / delta;
+
+        double y;
+        const double span = x - state.x2;
+        if (std::abs(span) >= ADAA_TOLERANCE)
+        {
+            y = 2.0 * (difference - state.difference) / span;
+        }
+        else
+        {
+            // Input returned to where it was two samples ago: expand around
+            // the mean of the two instead
+            const double mean = 0.5 * (x + state.x2);
+            const double offset = mean - state.x1;
+
+            if (std::abs(offset) < ADAA_TOLERANCE)
+                y = curve.value(0.5 * (mean + state.x1));
+            else
+                y = 2.0 / offset * (curve.antiderivative1(mean)
+                                    + (state.antiderivative - curve.antiderivative2(mean)) / offset);
+        }
+
+        state.x2 = state.x1;
+        state.x1 = x;
+        state.antiderivative = antiderivative;
+        state.difference = difference;
+        return static_cast<float>(y);
     }
 
     // Hysteresis approximation for tape saturation
@@ -60,6 +228,34 @@ namespace DSPUtils
         return state;
     }
 
+    // Hysteresis with an explicit per-sample lag coefficient (pre-scaled for
+    // the running rate), integrated in numSteps sub-steps. FastTanh selects
+    // the rational approximation used by the Eco quality tier.
+    template <bool FastTanh>
+    inline float hysteresis(float input, float& state, float saturation, float lagCoeff, int numSteps)
+    {
+        float drive = 1.0f + saturation * 3.0f;
+        float stepLag = lagCoeff / static_cast<float>(numSteps);
+
+        for (int step = 0; step < numSteps; ++step)
+        {
+            float diff = (input - state) * drive;
+            float saturatedDiff = (FastTanh ? fastTanh(diff) : std::tanh(diff)) / drive;
+            state += saturatedDiff * stepLag;
+        }
+
+        return state;
+    }
+
+    // 4-point cubic Hermite interpolation between y1 and y2
+    inline float hermiteInterpolate(float y0, float y1, float y2, float y3, float frac)
+    {
+        float c1 = 0.5f * (y2 - y0);
+        float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+        float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+        return ((c3 * frac + c2) * frac + c1) * frac + y1;
+    }
+
     inline float hardClip(float sample, float threshold = 1.0f)
     {
         return std::clamp(sample, -threshold, threshold);
@@ -79,19 +275,38 @@ namespace DSPUtils
         return state;
     }
 
-    // Simple white noise generator
+    // Distinct seed per call without touching std::random_device (a system
+    // call on most platforms): a process-wide counter mixed with the clock
+    inline uint32_t makeSeed()
+    {
+        static std::atomic<uint32_t> counter { 0 };
+
+        auto ticks = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        uint64_t z = ticks + 0x9E3779B97F4A7C15ull * (counter.fetch_add(1, std::memory_order_relaxed) + 1);
+
+        // splitmix64 finaliser
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<uint32_t>(z ^ (z >> 31));
+    }
+
+    // Simple white noise generator (xorshift32: 4 bytes of state, cheap per sample)
     class NoiseGenerator
     {
     public:
-        NoiseGenerator() : gen(std::random_device{}()), dist(-1.0f, 1.0f) {}
+        NoiseGenerator() : state(makeSeed() | 1u) {}
+
+        void setSeed(uint32_t seed) { state = seed | 1u; }
 
         float nextSample()
         {
-            return dist(gen);
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return static_cast<float>(static_cast<int32_t>(state)) * (1.0f / 2147483648.0f);
         }
 
     private:
-        std::mt19937 gen;
-        std::uniform_real_distribution<float> dist;
+        uint32_t state;
     };
 }
@@ -0,0 +1,265 @@
+#include "LoudnessMeter.h"
+#include <cmath>
+
+//==============================================================================
+// One low-priority thread for every meter in the process
+class LoudnessMeter::AnalysisThread : public juce::TimeSliceThread
+{
+public:
+    AnalysisThread() : juce::TimeSliceThread("TapeWarm analysis")
+    {
+        startThread(juce::Thread::Priority::low);
+    }
+
+    ~AnalysisThread() override
+    {
+        stopThread(1000);
+    }
+};
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter()
+    : histogramEnergy(HISTOGRAM_BINS, 0.0),
+      histogramCount(HISTOGRAM_BINS, 0)
+{
+    // True-peak interpolator: Blackman-windowed sinc split into polyphase
+    // branches, each normalised to unity gain at DC
+    constexpr int numTaps = TRUE_PEAK_PHASES * TRUE_PEAK_TAPS;
+    const double centre = (numTaps - 1) * 0.5;
+
+    for (int phase = 0; phase < TRUE_PEAK_PHASES; ++phase)
+    {
+        double sum = 0.0;
+        std::array<double, TRUE_PEAK_TAPS> taps {};
+
+        for (int k = 0; k < TRUE_PEAK_TAPS; ++k)
+        {
+            const int n = phase + k * TRUE_PEAK_PHASES;
+            const double x = (n - centre) / TRUE_PEAK_PHASES;
+            const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            const double w = 2.0 * juce::MathConstants<double>::pi * n / (numTaps - 1);
+            const double window = 0.42 - 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+
+            taps[static_cast<size_t>(k)] = sinc * window;
+            sum += taps[static_cast<size_t>(k)];
+        }
+
+        for (int k = 0; k < TRUE_PEAK_TAPS; ++k)
+            interpolator[static_cast<size_t>(phase)][static_cast<size_t>(k)] = static_cast<float>(taps[static_cast<size_t>(k)] / sum);
+    }
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+    thread->removeTimeSliceClient(this);
+}
+
+void LoudnessMeter::prepare(double sampleRate, int numInputChannels)
+{
+    // Blocks until any analysis of this meter in progress has finished
+    thread->removeTimeSliceClient(this);
+
+    numChannels = juce::jlimit(1, MAX_CHANNELS, numInputChannels);
+    fifoBuffer.setSize(MAX_CHANNELS, FIFO_SIZE);
+    fifo.reset();
+
+    // K-weighting for this sample rate (BS.1770 high shelf and RLB highpass)
+    {
+        const double k = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+        const double q = 0.7071752369554196;
+        const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        preFilter.b0 = (vh + vb * k / q + k * k) / a0;
+        preFilter.b1 = 2.0 * (k * k - vh) / a0;
+        preFilter.b2 = (vh - vb * k / q + k * k) / a0;
+        preFilter.a1 = 2.0 * (k * k - 1.0) / a0;
+        preFilter.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double k = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+        const double q = 0.5003270373238773;
+        const double a0 = 1.0 + k / q + k * k;
+
+        rlbFilter.b0 = 1.0;
+        rlbFilter.b1 = -2.0;
+        rlbFilter.b2 = 1.0;
+        rlbFilter.a1 = 2.0 * (k * k - 1.0) / a0;
+        rlbFilter.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+    resetRequested.store(false);
+    clearAnalysis();
+
+    thread->addTimeSliceClient(this);
+}
+
+void LoudnessMeter::push(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    if (fifoBuffer.getNumSamples() == 0)
+        return;
+
+    // Drop what does not fit rather than wait for the analysis thread
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
+
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        if (size1 > 0)
+            fifoBuffer.copyFrom(ch, start1, buffer, ch, 0, size1);
+        if (size2 > 0)
+            fifoBuffer.copyFrom(ch, start2, buffer, ch, size1, size2);
+    }
+
+    fifo.finishedWrite(size1 + size2);
+}
+
+int LoudnessMeter::useTimeSlice()
+{
+    if (resetRequested.exchange(false))
+        clearAnalysis();
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    const float* channels[MAX_CHANNELS];
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        channels[ch] = fifoBuffer.getReadPointer(ch, start1);
+    analyse(channels, size1);
+
+    if (size2 > 0)
+    {
+        for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+            channels[ch] = fifoBuffer.getReadPointer(ch, start2);
+        analyse(channels, size2);
+    }
+
+    truePeak.store(peak > 0.0f ? juce::Decibels::gainToDecibels(peak, SILENCE) : SILENCE);
+    fifo.finishedRead(size1 + size2);
+
+    return 20;
+}
+
+void LoudnessMeter::analyse(const float* const* channels, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& state = channelState[static_cast<size_t>(ch)];
+            const float input = channels[ch][i];
+
+            // True peak: every interpolated phase of the newest sample
+            std::copy_backward(state.history.begin(), state.history.end() - 1, state.history.end());
+            state.history[0] = input;
+
+            for (const auto& taps : interpolator)
+            {
+                float interpolated = 0.0f;
+                for (size_t k = 0; k < TRUE_PEAK_TAPS; ++k)
+                    interpolated += taps[k] * state.history[k];
+                peak = std::max(peak, std::abs(interpolated));
+            }
+            peak = std::max(peak, std::abs(input));
+
+            // K-weighting, two biquads
+            double y = input;
+            int stage = 0;
+            for (const auto* filter : { &preFilter, &rlbFilter })
+            {
+                const double x = y;
+                y = filter->b0 * x + state.s1[stage];
+                state.s1[stage] = filter->b1 * x - filter->a1 * y + state.s2[stage];
+                state.s2[stage] = filter->b2 * x - filter->a2 * y;
+                ++stage;
+            }
+
+            subBlockEnergy += y * y;
+        }
+
+        if (++subBlockPosition == subBlockLength)
+            completeSubBlock();
+    }
+}
+
+void LoudnessMeter::completeSubBlock()
+{
+    subBlocks[static_cast<size_t>(subBlockIndex)] = subBlockEnergy;
+    subBlockIndex = (subBlockIndex + 1) % SHORT_TERM_BLOCKS;
+    numSubBlocks = std::min(numSubBlocks + 1, SHORT_TERM_BLOCKS);
+    subBlockEnergy = 0.0;
+    subBlockPosition = 0;
+
+    auto windowPower = [this](int numBlocks)
+    {
+        double energy = 0.0;
+        for (int i = 1; i <= numBlocks; ++i)
+            energy += subBlocks[static_cast<size_t>((subBlockIndex - i + SHORT_TERM_BLOCKS) % SHORT_TERM_BLOCKS)];
+        return energy / (static_cast<double>(numBlocks) * subBlockLength);
+    };
+
+    shortTerm.store(toLoudness(windowPower(numSubBlocks)));
+
+    if (numSubBlocks < MOMENTARY_BLOCKS)
+        return;
+
+    // Each 400 ms window (75% overlap) is a gating block for the integrated loudness
+    const double blockPower = windowPower(MOMENTARY_BLOCKS);
+    const float blockLoudness = toLoudness(blockPower);
+    momentary.store(blockLoudness);
+
+    if (blockLoudness < HISTOGRAM_MIN)
+        return;  // Absolute gate
+
+    const auto bin = static_cast<size_t>(juce::jlimit(0, HISTOGRAM_BINS - 1, static_cast<int>((blockLoudness - HISTOGRAM_MIN) * 10.0f)));
+    histogramEnergy[bin] += blockPower;
+    ++histogramCount[bin];
+
+    // Relative gate: 10 LU below the mean of the blocks above the absolute gate
+    double totalEnergy = 0.0;
+    int totalCount = 0;
+    for (size_t i = 0; i < histogramEnergy.size(); ++i)
+    {
+        totalEnergy += histogramEnergy[i];
+        totalCount += histogramCount[i];
+    }
+
+    const float relativeGate = toLoudness(totalEnergy / totalCount) - 10.0f;
+    const auto firstBin = static_cast<size_t>(juce::jlimit(0, HISTOGRAM_BINS - 1, static_cast<int>(std::ceil((relativeGate - HISTOGRAM_MIN) * 10.0f))));
+
+    double gatedEnergy = 0.0;
+    int gatedCount = 0;
+    for (size_t i = firstBin; i < histogramEnergy.size(); ++i)
+    {
+        gatedEnergy += histogramEnergy[i];
+        gatedCount += histogramCount[i];
+    }
+
+    integrated.store(gatedCount > 0 ? toLoudness(gatedEnergy / gatedCount) : SILENCE);
+}
+
+void LoudnessMeter::clearAnalysis()
+{
+    channelState = {};
+    subBlocks = {};
+    subBlockIndex = 0;
+    numSubBlocks = 0;
+    subBlockPosition = 0;
+    subBlockEnergy = 0.0;
+    std::fill(histogramEnergy.begin(), histogramEnergy.end(), 0.0);
+    std::fill(histogramCount.begin(), histogramCount.end(), 0);
+    peak = 0.0f;
+
+    momentary.store(SILENCE);
+    shortTerm.store(SILENCE);
+    integrated.store(SILENCE);
+    truePeak.store(SILENCE);
+}
+
+float LoudnessMeter::toLoudness(double power)
+{
+    return power > 0.0 ? std::max(SILENCE, static_cast<float>(-0.691 + 10.0 * std::log10(power))) : SILENCE;
+}
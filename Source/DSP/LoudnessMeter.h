@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// ITU-R BS.1770 loudness (momentary, short-term, integrated) and true peak.
+//
+// The audio thread only copies samples into a wait-free FIFO. K-weighting,
+// gating and the 4x true-peak interpolation run on one analysis thread
+// shared by every meter in the process, and results are published through
+// atomics.
+class LoudnessMeter : private juce::TimeSliceClient
+{
+public:
+    LoudnessMeter();
+    ~LoudnessMeter() override;
+
+    // Not concurrently with push(); the analysis of this meter is paused meanwhile
+    void prepare(double sampleRate, int numChannels);
+
+    // Audio thread
+    void push(const juce::AudioBuffer<float>& buffer) noexcept;
+
+    // Any thread: restarts integration and the true-peak hold
+    void reset() noexcept { resetRequested.store(true); }
+
+    // Any thread: false once the analysis thread has taken in, and published
+    // the results for, everything pushed so far
+    bool hasPendingSamples() const noexcept { return fifo.getNumReady() > 0; }
+
+    // LUFS, or dBTP for the true peak (held since the last reset); -100 before any signal
+    float getMomentary() const { return momentary.load(); }
+    float getShortTerm() const { return shortTerm.load(); }
+    float getIntegrated() const { return integrated.load(); }
+    float getTruePeak() const { return truePeak.load(); }
+
+    static constexpr float SILENCE = -100.0f;
+
+private:
+    class AnalysisThread;
+
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int FIFO_SIZE = 1 << 14;           // ~340 ms at 48 kHz; drained every 20 ms
+    static constexpr int SHORT_TERM_BLOCKS = 30;        // 100 ms sub-blocks
+    static constexpr int MOMENTARY_BLOCKS = 4;
+
+    // Gating histogram: 0.1 LU bins from the absolute gate up to +10 LUFS
+    static constexpr float HISTOGRAM_MIN = -70.0f;
+    static constexpr int HISTOGRAM_BINS = 800;
+
+    // True peak: 4x polyphase interpolator, 12 taps per phase
+    static constexpr int TRUE_PEAK_PHASES = 4;
+    static constexpr int TRUE_PEAK_TAPS = 12;
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct ChannelState
+    {
+        double s1[2] {};                                // K-weighting stages, transposed direct form II
+        double s2[2] {};
+        std::array<float, TRUE_PEAK_TAPS> history {};  // Most recent sample first
+    };
+
+    int useTimeSlice() override;
+
+    void analyse(const float* const* channels, int numSamples);
+    void completeSubBlock();
+    void clearAnalysis();
+    static float toLoudness(double power);
+
+    juce::SharedResourcePointer<AnalysisThread> thread;
+
+    // Audio thread -> analysis thread
+    juce::AbstractFifo fifo { FIFO_SIZE };
+    juce::AudioBuffer<float> fifoBuffer;
+    std::atomic<bool> resetRequested { false };
+
+    // Analysis thread only
+    int numChannels = 2;
+    Biquad preFilter, rlbFilter;
+    std::array<ChannelState, MAX_CHANNELS> channelState;
+    std::array<std::array<float, TRUE_PEAK_TAPS>, TRUE_PEAK_PHASES> interpolator {};
+    int subBlockLength = 4800;
+    int subBlockPosition = 0;
+    double subBlockEnergy = 0.0;
+    std::array<double, SHORT_TERM_BLOCKS> subBlocks {};
+    int subBlockIndex = 0;
+    int numSubBlocks = 0;
+    std::vector<double> histogramEnergy;
+    std::vector<int> histogramCount;
+    float peak = 0.0f;
+
+    // Results
+    std::atomic<float> momentary { SILENCE };
+    std::atomic<float> shortTerm { SILENCE };
+    std::atomic<float> integrated { SILENCE };
+    std::atomic<float> truePeak { SILENCE };
+
+    JUCE_DECLARE_NON_COPYABLE(LoudnessMeter)
+};
@@ -0,0 +1,415 @@
+#include "MachineResponse.h"
+#include "RealtimeChecker.h"
+#include <cmath>
+#include <complex>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    // Synthesised contour: a low cut from the head, then alternating bumps
+    // and dips (gain in dB) whose frequencies scale with tape speed. The
+    // primary bumps match the biquad head bump at its default frequency
+    struct ContourBand
+    {
+        double frequency, gainDb, q;
+    };
+
+    constexpr int NUM_CONTOUR_BANDS = 4;
+
+    struct Contour
+    {
+        double lowCutFrequency;
+        ContourBand bands[NUM_CONTOUR_BANDS];
+    };
+
+    constexpr Contour contours[] =
+    {
+        { 20.0, { {  55.0, 3.5, 1.4 }, { 110.0, -1.5, 2.0 }, { 175.0, 1.0, 2.5 }, { 280.0, -0.7, 3.0 } } },   // 7.5 IPS
+        { 25.0, { {  80.0, 3.0, 1.4 }, { 160.0, -1.5, 2.0 }, { 255.0, 0.8, 2.5 }, { 410.0, -0.5, 3.0 } } },   // 15 IPS
+        { 30.0, { { 120.0, 2.5, 1.4 }, { 240.0, -1.2, 2.0 }, { 385.0, 0.6, 2.5 }, { 620.0, -0.4, 3.0 } } }    // 30 IPS
+    };
+
+    constexpr double SYNTHESISED_SECONDS = 0.1;     // Slowest band has decayed below -80 dB
+    constexpr double MAX_MEASURED_SECONDS = 0.25;
+
+    // Direct form I biquad in double precision, for rendering responses
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+
+        double process(double x)
+        {
+            const double y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            return y;
+        }
+
+        void set(double nb0, double nb1, double nb2, double a0, double na1, double na2)
+        {
+            b0 = nb0 / a0;
+            b1 = nb1 / a0;
+            b2 = nb2 / a0;
+            a1 = na1 / a0;
+            a2 = na2 / a0;
+        }
+    };
+}
+
+//==============================================================================
+std::shared_ptr<const MachineResponseSet> MachineResponseSet::acquire(double sampleRate)
+{
+    // One set per sample rate in use
+    static std::mutex mutex;
+    static std::map<int, std::weak_ptr<const MachineResponseSet>> shared;
+
+    RealtimeChecker::checkBlockingCall("MachineResponseSet::acquire lock");
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto& entry = shared[juce::roundToInt(sampleRate)];
+    auto responseSet = entry.lock();
+    if (responseSet == nullptr)
+    {
+        responseSet = std::shared_ptr<const MachineResponseSet>(new MachineResponseSet(sampleRate));
+        entry = responseSet;
+    }
+
+    return responseSet;
+}
+
+MachineResponseSet::MachineResponseSet(double sampleRate)
+{
+    const juce::dsp::FFT fft(FFT_ORDER);
+
+    for (int m = 0; m < NUM_MACHINE_TYPES; ++m)
+    {
+        const auto machineType = static_cast<MachineType>(m);
+
+        // The synthesised contour is a cascade of minimum phase biquads;
+        // measurements carry the capture's delay and excess phase
+        auto impulseResponse = loadMeasured(machineType, sampleRate);
+        const bool measured = ! impulseResponse.empty();
+        if (measured)
+            impulseResponse = makeMinimumPhase(impulseResponse);
+        else
+            impulseResponse = synthesise(machineType, sampleRate);
+
+        responses[m] = partition(impulseResponse, fft);
+        responses[m].measured = measured;
+    }
+}
+
+int MachineResponseSet::getMaxPartitions() const
+{
+    int maxPartitions = 0;
+    for (const auto& response : responses)
+        maxPartitions = std::max(maxPartitions, response.numPartitions);
+    return maxPartitions;
+}
+
+size_t MachineResponseSet::getMemoryBytes() const
+{
+    size_t bytes = sizeof(*this);
+    for (const auto& response : responses)
+        bytes += (response.head.size() + response.tail.size()) * sizeof(float);
+    return bytes;
+}
+
+juce::File MachineResponseSet::getMeasuredResponseFile(MachineType machineType)
+{
+    static const char* const names[] = { "7.5ips", "15ips", "30ips" };
+
+    const auto folder = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                            .getChildFile("TapeWarm").getChildFile("Responses");
+
+    for (const auto* extension : { ".wav", ".aif", ".aiff" })
+    {
+        const auto file = folder.getChildFile(juce::String(names[static_cast<int>(machineType)]) + extension);
+        if (file.existsAsFile())
+            return file;
+    }
+
+    return folder.getChildFile(juce::String(names[static_cast<int>(machineType)]) + ".wav");
+}
+
+std::vector<float> MachineResponseSet::loadMeasured(MachineType machineType, double sampleRate)
+{
+    const auto file = getMeasuredResponseFile(machineType);
+    if (! file.existsAsFile())
+        return {};
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+        return {};
+
+    // First channel, up to MAX_MEASURED_SECONDS
+    const int length = static_cast<int>(std::min<juce::int64>(reader->lengthInSamples,
+                                                              static_cast<juce::int64>(reader->sampleRate * MAX_MEASURED_SECONDS)));
+    juce::AudioBuffer<float> buffer(1, length);
+    buffer.clear();
+    reader->read(&buffer, 0, length, 0, true, false);
+    const float* source = buffer.getReadPointer(0);
+
+    // Windowed-sinc resampling to the session rate, band-limited to the
+    // lower of the two rates. Tap values scale with the sample period
+    const double ratio = reader->sampleRate / sampleRate;   // Source samples per output sample
+    const double cutoff = std::min(1.0, 1.0 / ratio);
+    const double halfWidth = 16.0 / cutoff;                 // Source samples either side
+
+    std::vector<float> impulseResponse(static_cast<size_t>(std::ceil(length / ratio)));
+
+    for (size_t n = 0; n < impulseResponse.size(); ++n)
+    {
+        const double centre = static_cast<double>(n) * ratio;
+        const int first = std::max(0, static_cast<int>(std::ceil(centre - halfWidth)));
+        const int last = std::min(length - 1, static_cast<int>(std::floor(centre + halfWidth)));
+
+        double sum = 0.0;
+        for (int k = first; k <= last; ++k)
+        {
+            const double t = (k - centre) * cutoff;
+            const double sinc = std::abs(t) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+            const double window = 0.5 + 0.5 * std::cos(juce::MathConstants<double>::pi * (k - centre) / halfWidth);
+            sum += source[k] * sinc * window;
+        }
+
+        impulseResponse[n] = static_cast<float>(sum * cutoff * ratio);
+    }
+
+    return impulseResponse;
+}
+
+std::vector<float> MachineResponseSet::synthesise(MachineType machineType, double sampleRate)
+{
+    const auto& contour = contours[static_cast<int>(machineType)];
+    const double twoPi = 2.0 * juce::MathConstants<double>::pi;
+
+    // Second-order low cut and peaking bands (RBJ cookbook)
+    Biquad filters[1 + NUM_CONTOUR_BANDS];
+    {
+        const double omega = twoPi * contour.lowCutFrequency / sampleRate;
+        const double alpha = std::sin(omega) / (2.0 * 0.7071);
+        const double cosOmega = std::cos(omega);
+        filters[0].set((1.0 + cosOmega) / 2.0, -(1.0 + cosOmega), (1.0 + cosOmega) / 2.0,
+                       1.0 + alpha, -2.0 * cosOmega, 1.0 - alpha);
+    }
+
+    for (int b = 0; b < NUM_CONTOUR_BANDS; ++b)
+    {
+        const auto& band = contour.bands[b];
+        const double A = std::pow(10.0, band.gainDb / 40.0);
+        const double omega = twoPi * band.frequency / sampleRate;
+        const double alpha = std::sin(omega) / (2.0 * band.q);
+        const double cosOmega = std::cos(omega);
+        filters[b + 1].set(1.0 + alpha * A, -2.0 * cosOmega, 1.0 - alpha * A,
+                           1.0 + alpha / A, -2.0 * cosOmega, 1.0 - alpha / A);
+    }
+
+    // Impulse through the cascade, faded out over the last quarter
+    const int length = static_cast<int>(std::ceil(sampleRate * SYNTHESISED_SECONDS));
+    const int fadeStart = length - length / 4;
+    std::vector<float> impulseResponse(static_cast<size_t>(length));
+
+    for (int n = 0; n < length; ++n)
+    {
+        double y = (n == 0) ? 1.0 : 0.0;
+        for (auto& filter : filters)
+            y = filter.process(y);
+
+        if (n >= fadeStart)
+            y *= 0.5 + 0.5 * std::cos(juce::MathConstants<double>::pi * (n - fadeStart) / (length - fadeStart));
+
+        impulseResponse[static_cast<size_t>(n)] = static_cast<float>(y);
+    }
+
+    return impulseResponse;
+}
+
+std::vector<float> MachineResponseSet::makeMinimumPhase(const std::vector<float>& impulseResponse)
+{
+    // Homomorphic method: the causal part of the real cepstrum of the
+    // magnitude response. Padding well past the response keeps the
+    // cepstrum from aliasing
+    const int length = static_cast<int>(impulseResponse.size());
+    const int order = juce::jlimit(FFT_ORDER, 20, static_cast<int>(std::ceil(std::log2(std::max(1, length)))) + 3);
+    const int size = 1 << order;
+    const juce::dsp::FFT fft(order);
+
+    std::vector<float> work(static_cast<size_t>(size) * 2, 0.0f);
+    std::copy(impulseResponse.begin(), impulseResponse.end(), work.begin());
+    fft.performRealOnlyForwardTransform(work.data(), true);
+
+    // Log magnitude, floored 120 dB below the peak so deep notches stay finite
+    float peak = 0.0f;
+    for (int k = 0; k <= size / 2; ++k)
+        peak = std::max(peak, std::hypot(work[(size_t) (2 * k)], work[(size_t) (2 * k + 1)]));
+
+    const float floor = std::max(peak, 1.0e-20f) * 1.0e-6f;
+    for (int k = 0; k <= size / 2; ++k)
+    {
+        work[(size_t) (2 * k)] = std::log(std::max(std::hypot(work[(size_t) (2 * k)], work[(size_t) (2 * k + 1)]), floor));
+        work[(size_t) (2 * k + 1)] = 0.0f;
+    }
+
+    fft.performRealOnlyInverseTransform(work.data());
+
+    // Fold the cepstrum onto positive quefrencies
+    for (int n = 1; n < size / 2; ++n)
+        work[(size_t) n] *= 2.0f;
+    std::fill(work.begin() + size / 2 + 1, work.end(), 0.0f);
+
+    fft.performRealOnlyForwardTransform(work.data(), true);
+
+    for (int k = 0; k <= size / 2; ++k)
+    {
+        const auto bin = std::exp(std::complex<float>(work[(size_t) (2 * k)], work[(size_t) (2 * k + 1)]));
+        work[(size_t) (2 * k)] = bin.real();
+        work[(size_t) (2 * k + 1)] = bin.imag();
+    }
+
+    fft.performRealOnlyInverseTransform(work.data());
+
+    return std::vector<float>(work.begin(), work.begin() + length);
+}
+
+MachineResponseSet::Response MachineResponseSet::partition(const std::vector<float>& impulseResponse, const juce::dsp::FFT& fft)
+{
+    Response response;
+    const int length = static_cast<int>(impulseResponse.size());
+
+    response.head.assign(PARTITION_SIZE, 0.0f);
+    std::copy_n(impulseResponse.begin(), std::min(length, PARTITION_SIZE), response.head.begin());
+
+    response.numPartitions = (std::max(0, length - PARTITION_SIZE) + PARTITION_SIZE - 1) / PARTITION_SIZE;
+    response.tail.assign(static_cast<size_t>(response.numPartitions * NUM_BINS * 2), 0.0f);
+
+    // Each tail partition zero-padded to the FFT size (overlap-save)
+    std::vector<float> workspace(FFT_SIZE * 2);
+
+    for (int p = 0; p < response.numPartitions; ++p)
+    {
+        std::fill(workspace.begin(), workspace.end(), 0.0f);
+
+        const int start = (p + 1) * PARTITION_SIZE;
+        const int count = std::min(PARTITION_SIZE, length - start);
+        std::copy_n(impulseResponse.begin() + start, count, workspace.begin());
+
+        fft.performRealOnlyForwardTransform(workspace.data(), true);
+        std::copy_n(workspace.begin(), NUM_BINS * 2, response.tail.begin() + p * NUM_BINS * 2);
+    }
+
+    return response;
+}
+
+//==============================================================================
+void MachineConvolver::prepare(const MachineResponseSet& responseSet, int numChannels)
+{
+    maxPartitions = std::max(1, responseSet.getMaxPartitions());
+
+    channels.resize(static_cast<size_t>(numChannels));
+    for (auto& state : channels)
+    {
+        state.input.assign(PARTITION_SIZE * 2, 0.0f);
+        state.spectra.assign(static_cast<size_t>(maxPartitions * NUM_BINS * 2), 0.0f);
+        state.tail.assign(PARTITION_SIZE, 0.0f);
+    }
+
+    scratch.assign(MachineResponseSet::FFT_SIZE * 2, 0.0f);
+    reset();
+}
+
+void MachineConvolver::reset()
+{
+    for (auto& state : channels)
+    {
+        std::fill(state.input.begin(), state.input.end(), 0.0f);
+        std::fill(state.spectra.begin(), state.spectra.end(), 0.0f);
+        std::fill(state.tail.begin(), state.tail.end(), 0.0f);
+        state.position = 0;
+        state.newestSpectrum = 0;
+    }
+}
+
+void MachineConvolver::copyChannel(int source, int destination) noexcept
+{
+    // Same sizes, so the vectors reuse their storage
+    channels[static_cast<size_t>(destination)] = channels[static_cast<size_t>(source)];
+}
+
+size_t MachineConvolver::getMemoryBytes() const
+{
+    size_t bytes = scratch.size() * sizeof(float);
+    for (const auto& state : channels)
+        bytes += (state.input.size() + state.spectra.size() + state.tail.size()) * sizeof(float);
+    return bytes;
+}
+
+void MachineConvolver::process(const MachineResponseSet::Response& response, int channel, float* data, int numSamples,
+                               const TapeKernels::KernelTable& kernels) noexcept
+{
+    auto& state = channels[static_cast<size_t>(channel)];
+    float* input = state.input.data();
+    const float* head = response.head.data();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        input[PARTITION_SIZE + state.position] = data[i];
+
+        // Head taps directly, so there is no latency; the tail of this
+        // partition was computed when the previous one completed
+        const float* newest = input + PARTITION_SIZE + state.position;
+        float sum = state.tail[static_cast<size_t>(state.position)];
+        for (int k = 0; k < PARTITION_SIZE; ++k)
+            sum += head[k] * newest[-k];
+        data[i] = sum;
+
+        if (++state.position == PARTITION_SIZE)
+            completePartition(response, state, kernels);
+    }
+}
+
+void MachineConvolver::completePartition(const MachineResponseSet::Response& response, Channel& state,
+                                         const TapeKernels::KernelTable& kernels) noexcept
+{
+    constexpr int spectrumSize = NUM_BINS * 2;
+    float* input = state.input.data();
+    float* work = scratch.data();
+
+    // Spectrum of the previous and current input partitions
+    state.newestSpectrum = (state.newestSpectrum + 1) % maxPartitions;
+    float* newest = state.spectra.data() + state.newestSpectrum * spectrumSize;
+
+    std::copy(input, input + PARTITION_SIZE * 2, work);
+    std::fill(work + PARTITION_SIZE * 2, work + scratch.size(), 0.0f);
+    fft.performRealOnlyForwardTransform(work, true);
+    std::copy(work, work + spectrumSize, newest);
+
+    // Tail for the next partition: each IR partition against the input
+    // spectrum that many partitions back
+    std::fill(scratch.begin(), scratch.end(), 0.0f);
+    const int numPartitions = std::min(response.numPartitions, maxPartitions);
+
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        int index = state.newestSpectrum - p;
+        if (index < 0)
+            index += maxPartitions;
+
+        kernels.complexMultiplyAdd(work, response.tail.data() + p * spectrumSize,
+                                   state.spectra.data() + index * spectrumSize, NUM_BINS);
+    }
+
+    fft.performRealOnlyInverseTransform(work);
+    std::copy(work + PARTITION_SIZE, work + PARTITION_SIZE * 2, state.tail.begin());
+
+    // The current partition becomes the previous one
+    std::copy(input + PARTITION_SIZE, input + PARTITION_SIZE * 2, input);
+    state.position = 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TapeKernels.h"
+#include "TapeModel.h"
+#include <memory>
+#include <vector>
+
+// Playback response of each machine (the bumps, dips and phase shift of the
+// low-frequency head contour), applied by zero-latency uniformly
+// partitioned convolution as an alternative to the head bump biquad.
+//
+// Impulse responses come from measured files when present, otherwise they
+// are synthesised from a model of the contour. Either way they are
+// minimum phase, so blending one with the dry signal adds no comb filtering,
+// and are partitioned and transformed once per process and sample rate,
+// shared by every instance; each instance only holds its input history.
+class MachineResponseSet
+{
+public:
+    // The first PARTITION_SIZE taps run in the time domain (no latency), the
+    // rest in PARTITION_SIZE-sample FFT partitions
+    static constexpr int PARTITION_SIZE = 64;
+    static constexpr int FFT_ORDER = 7;
+    static constexpr int FFT_SIZE = 1 << FFT_ORDER;
+    static constexpr int NUM_BINS = FFT_SIZE / 2 + 1;
+
+    struct Response
+    {
+        std::vector<float> head;        // Taps 0 to PARTITION_SIZE - 1
+        std::vector<float> tail;        // Spectrum of each later partition, NUM_BINS interleaved complex values
+        int numPartitions = 0;          // Tail partitions
+        bool measured = false;          // Loaded from a file rather than synthesised
+    };
+
+    // Call from a non-realtime thread (prepare)
+    static std::shared_ptr<const MachineResponseSet> acquire(double sampleRate);
+
+    const Response& get(MachineType machineType) const { return responses[static_cast<int>(machineType)]; }
+
+    int getMaxPartitions() const;
+    size_t getMemoryBytes() const;
+
+    // Measured response for a machine: a mono WAV or AIFF at any rate, e.g.
+    // "<user app data>/TapeWarm/Responses/15ips.wav"
+    static juce::File getMeasuredResponseFile(MachineType machineType);
+
+private:
+    explicit MachineResponseSet(double sampleRate);
+
+    static std::vector<float> loadMeasured(MachineType machineType, double sampleRate);
+    static std::vector<float> synthesise(MachineType machineType, double sampleRate);
+    static std::vector<float> makeMinimumPhase(const std::vector<float>& impulseResponse);
+    static Response partition(const std::vector<float>& impulseResponse, const juce::dsp::FFT& fft);
+
+    static constexpr int NUM_MACHINE_TYPES = 3;
+
+    Response responses[NUM_MACHINE_TYPES];
+};
+
+// One instance's convolution state, for up to two channels
+class MachineConvolver
+{
+public:
+    // Sizes the history for the longest response in the set (non-realtime)
+    void prepare(const MachineResponseSet& responseSet, int numChannels);
+    void reset();
+
+    // In place. The response may change between calls; the history carries over
+    void process(const MachineResponseSet::Response& response, int channel, float* data, int numSamples,
+                 const TapeKernels::KernelTable& kernels) noexcept;
+
+    // Makes channel 1 continue from channel 0 (channels unlinked after dual mono)
+    void copyChannel(int source, int destination) noexcept;
+
+    size_t getMemoryBytes() const;
+
+private:
+    static constexpr int PARTITION_SIZE = MachineResponseSet::PARTITION_SIZE;
+    static constexpr int NUM_BINS = MachineResponseSet::NUM_BINS;
+
+    struct Channel
+    {
+        std::vector<float> input;       // Previous and current partition of input
+        std::vector<float> spectra;     // Spectra of past input partitions, a ring of maxPartitions
+        std::vector<float> tail;        // Tail contribution to the current partition
+        int position = 0;               // Samples into the current partition
+        int newestSpectrum = 0;
+    };
+
+    void completePartition(const MachineResponseSet::Response& response, Channel& state,
+                           const TapeKernels::KernelTable& kernels) noexcept;
+
+    juce::dsp::FFT fft { MachineResponseSet::FFT_ORDER };
+    std::vector<Channel> channels;
+    std::vector<float> scratch;         // FFT workspace, 2 * FFT_SIZE
+    int maxPartitions = 0;
+};
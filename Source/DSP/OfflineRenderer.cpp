@@ -0,0 +1,155 @@
+#include "OfflineRenderer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+static_assert(OfflineRenderer::BLOCK_SIZE % TapeProcessor::TIMELINE_ALIGNMENT == 0,
+              "Chunk and pre-roll starts must be valid timeline seek positions");
+
+namespace
+{
+    int roundUpToBlock(double samples)
+    {
+        const int blocks = static_cast<int>(std::ceil(samples / OfflineRenderer::BLOCK_SIZE));
+        return std::max(1, blocks) * OfflineRenderer::BLOCK_SIZE;
+    }
+}
+
+void OfflineRenderer::render(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, double sampleRate,
+                             const Configure& configure, const Options& options)
+{
+    jassert(&input != &output);
+
+    const int numChannels = input.getNumChannels();
+    const int numSamples = input.getNumSamples();
+    output.setSize(numChannels, numSamples, false, false, true);
+
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    // Chunks and pre-rolls start on the block grid, so every processor slices
+    // its blocks into control ticks at the same absolute positions
+    const int chunkLength = roundUpToBlock(sampleRate * options.chunkSeconds);
+    const int preRoll = options.preRollSeconds > 0.0 ? roundUpToBlock(sampleRate * options.preRollSeconds) : 0;
+
+    std::vector<Chunk> chunks;
+    for (int first = 0; first < numChannels; first += 2)
+        for (int start = 0; start < numSamples; start += chunkLength)
+            chunks.push_back({ first, std::min(2, numChannels - first), start, std::min(chunkLength, numSamples - start) });
+
+    // Raw pointers, taken here: the buffers' own accessors are not safe to
+    // call from several threads
+    const float* const* inputChannels = input.getArrayOfReadPointers();
+    float* const* outputChannels = output.getArrayOfWritePointers();
+
+    runJobs(options.numThreads, static_cast<int>(chunks.size()), [&](int index)
+    {
+        renderChunk(inputChannels, outputChannels, numSamples, chunks[static_cast<size_t>(index)], preRoll,
+                    sampleRate, configure, options.seed);
+    });
+}
+
+void OfflineRenderer::renderClips(const std::vector<Clip>& clips, double sampleRate, const Configure& configure,
+                                  const Options& options)
+{
+    if (clips.empty())
+        return;
+
+    const int numWorkers = options.numThreads > 0 ? options.numThreads : juce::SystemStats::getNumCpus();
+    std::atomic<size_t> nextClip { 0 };
+
+    // One processor per worker, taking clips until none are left
+    runJobs(numWorkers, std::min(numWorkers, static_cast<int>(clips.size())), [&](int)
+    {
+        auto processor = createProcessor(sampleRate, configure, options.seed);
+
+        for (size_t index = nextClip++; index < clips.size(); index = nextClip++)
+        {
+            const auto& clip = clips[index];
+            jassert(clip.numChannels >= 1 && clip.numChannels <= 2);
+
+            processor->reset();
+            renderRange(*processor, clip.channels, clip.channels, clip.numChannels, clip.numSamples,
+                        0, 0, clip.numSamples);
+        }
+    });
+}
+
+void OfflineRenderer::renderChunk(const float* const* input, float* const* output, int numSamples, const Chunk& chunk,
+                                  int preRoll, double sampleRate, const Configure& configure, uint32_t seed)
+{
+    auto processor = createProcessor(sampleRate, configure, seed);
+
+    const int from = std::max(0, chunk.start - preRoll);
+    processor->seekTimeline(from);
+
+    renderRange(*processor, input + chunk.firstChannel, output + chunk.firstChannel, chunk.numChannels, numSamples,
+                from, chunk.start, chunk.start + chunk.length);
+}
+
+void OfflineRenderer::renderRange(TapeProcessor& processor, const float* const* input, float* const* output,
+                                  int numChannels, int numSamples, int from, int start, int end)
+{
+    const int latency = processor.getLatencySamples();
+
+    // Whole blocks only (zeros past the end of the file), so the slicing
+    // matches every other chunk's
+    juce::AudioBuffer<float> block(numChannels, BLOCK_SIZE);
+
+    for (int position = from; position < end + latency; position += BLOCK_SIZE)
+    {
+        const int available = juce::jlimit(0, BLOCK_SIZE, numSamples - position);
+        block.clear();
+        if (available > 0)
+            for (int ch = 0; ch < numChannels; ++ch)
+                block.copyFrom(ch, 0, input[ch] + position, available);
+
+        processor.process(block);
+
+        // Sample i of this block is output sample position + i - latency,
+        // never ahead of the input already read, so in place is safe
+        const int keepFrom = std::max(start, position - latency);
+        const int keepTo = std::min(end, position + BLOCK_SIZE - latency);
+        if (keepTo <= keepFrom)
+            continue;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* processed = block.getReadPointer(ch, keepFrom - (position - latency));
+            std::copy(processed, processed + (keepTo - keepFrom), output[ch] + keepFrom);
+        }
+    }
+}
+
+std::unique_ptr<TapeProcessor> OfflineRenderer::createProcessor(double sampleRate, const Configure& configure,
+                                                                uint32_t seed)
+{
+    auto processor = std::make_unique<TapeProcessor>();
+    configure(*processor);
+    processor->setTimeline(seed);
+    processor->prepare(sampleRate, BLOCK_SIZE);
+    return processor;
+}
+
+void OfflineRenderer::runJobs(int numThreads, int numJobs, const std::function<void(int)>& job)
+{
+    if (numThreads <= 0)
+        numThreads = juce::SystemStats::getNumCpus();
+
+    juce::ThreadPool pool(std::min(numThreads, numJobs));
+    juce::WaitableEvent finished;
+    std::atomic<int> remaining { numJobs };
+
+    for (int index = 0; index < numJobs; ++index)
+    {
+        pool.addJob([&, index]
+        {
+            job(index);
+
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
+
+    finished.wait();
+}
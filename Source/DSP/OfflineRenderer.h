@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TapeProcessor.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Renders whole files through the tape chain on every core, for bounces
+// and batch processing outside a host.
+//
+// The file is cut into chunks, each run by its own TapeProcessor starting a
+// pre-roll earlier, so filter, hysteresis, convolution and delay state has
+// converged by the time its output is kept. The processors run on the
+// sample position timeline (TapeProcessor::setTimeline), so wow/flutter and
+// hiss carry on across chunk boundaries. Channels go through in pairs, each
+// pair independently, so multichannel files spread over cores too.
+//
+// The output is latency compensated and matches a single-chunk render to
+// within NULL_TOLERANCE.
+//
+// renderClips() is for many short files instead: each worker thread keeps
+// one processor and resets it between clips, rather than preparing one per
+// chunk.
+class OfflineRenderer
+{
+public:
+    struct Options
+    {
+        int numThreads = 0;             // 0 for one per core
+        double chunkSeconds = 30.0;
+        double preRollSeconds = 1.0;
+        uint32_t seed = 1;              // Wow/flutter rates and random walk, hiss
+    };
+
+    // Sets up the parameters of one processor. Called once per chunk (or per
+    // worker), from the worker threads, so it must give the same result every time
+    using Configure = std::function<void(TapeProcessor&)>;
+
+    // Resizes output to match input; they must be different buffers
+    static void render(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, double sampleRate,
+                       const Configure& configure, const Options& options);
+
+    // A clip processed in place: up to two channels of numSamples each
+    struct Clip
+    {
+        float* channels[2];
+        int numChannels;
+        int numSamples;
+    };
+
+    // Each clip renders from a reset processor at timeline position 0, so the
+    // result does not depend on the thread or the order. Options::chunkSeconds
+    // and preRollSeconds are unused
+    static void renderClips(const std::vector<Clip>& clips, double sampleRate, const Configure& configure,
+                            const Options& options);
+
+    // Peak difference from a single-chunk render of the same input. After the
+    // pre-roll a chunk's state matches to within double rounding (the filters
+    // keep double state, the wow/flutter write head follows the seek), so
+    // only the odd sample rounds to a different float: a couple of ulps at
+    // the top of the output range
+    static constexpr float NULL_TOLERANCE = 2.0e-6f;   // -114 dBFS
+
+    // Processing block; also the chunk grid, a multiple of TIMELINE_ALIGNMENT
+    static constexpr int BLOCK_SIZE = 512;
+
+private:
+    struct Chunk
+    {
+        int firstChannel, numChannels;
+        int start, length;              // Output samples this chunk writes
+    };
+
+    static void renderChunk(const float* const* input, float* const* output, int numSamples, const Chunk& chunk,
+                            int preRoll, double sampleRate, const Configure& configure, uint32_t seed);
+
+    // Processes input samples from onward and writes output samples start to
+    // end - 1, latency compensated. Input and output may be the same channels
+    static void renderRange(TapeProcessor& processor, const float* const* input, float* const* output,
+                            int numChannels, int numSamples, int from, int start, int end);
+
+    static std::unique_ptr<TapeProcessor> createProcessor(double sampleRate, const Configure& configure,
+                                                          uint32_t seed);
+    static void runJobs(int numThreads, int numJobs, const std::function<void(int)>& job);
+};
@@ -0,0 +1,222 @@
+#include "PlaybackLoss.h"
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr int NUM_SHELVES = 2 * PlaybackLoss::NUM_SECTIONS;
+    constexpr int NUM_POINTS = 16;
+    constexpr int MAX_ITERATIONS = 8;
+
+    // Shelf corners are CORNER_RATIO apart from LOWEST_CORNER up, each kept
+    // below Nyquist; the fit covers FIT_LOW to FIT_HIGH (or 0.45 fs)
+    constexpr double LOWEST_CORNER = 1500.0;
+    constexpr double CORNER_RATIO = 3.0;
+    constexpr double FIT_LOW = 1000.0;
+    constexpr double FIT_HIGH = 20000.0;
+
+    // Shelves only cut: letting neighbours boost and cut against each other
+    // fits no better and makes the problem ill-conditioned
+    constexpr double MIN_SHELF_GAIN = -40.0;    // dB
+
+    // First-order high shelf (1 + r s) / (1 + s / r), s normalised to the
+    // corner and prewarped, for an HF gain of r^2 (gain in dB / 20)
+    struct Shelf
+    {
+        double warp = 1.0;              // 1 / tan(pi corner / fs)
+        double numerator[2] = { 1.0, 0.0 }, denominator[2] = { 1.0, 0.0 };
+        double gain = 1.0;              // r^2
+
+        void setGain(double gainDb)
+        {
+            const double r = std::pow(10.0, gainDb / 40.0);
+            gain = r * r;
+            numerator[0] = 1.0 + r * warp;
+            numerator[1] = 1.0 - r * warp;
+            denominator[0] = 1.0 + warp / r;
+            denominator[1] = 1.0 - warp / r;
+        }
+
+        // Squared magnitude at cos(omega) as a numerator and denominator
+        void getPower(double cosOmega, double& n, double& d) const
+        {
+            n = numerator[0] * numerator[0] + numerator[1] * numerator[1]
+              + 2.0 * numerator[0] * numerator[1] * cosOmega;
+            d = denominator[0] * denominator[0] + denominator[1] * denominator[1]
+              + 2.0 * denominator[0] * denominator[1] * cosOmega;
+        }
+
+        // Derivative of the response in dB with respect to the gain in dB
+        double getSlope(double cosOmega, double n, double d) const
+        {
+            return warp * warp * (1.0 - cosOmega) * (gain / n + 1.0 / (gain * d));
+        }
+    };
+
+    // Solves the NUM_SHELVES square system in place (Gaussian elimination,
+    // the matrix is symmetric positive definite once damped)
+    void solve(double (&matrix)[NUM_SHELVES][NUM_SHELVES], double (&vector)[NUM_SHELVES])
+    {
+        for (int column = 0; column < NUM_SHELVES; ++column)
+        {
+            for (int row = column + 1; row < NUM_SHELVES; ++row)
+            {
+                const double factor = matrix[row][column] / matrix[column][column];
+                for (int k = column; k < NUM_SHELVES; ++k)
+                    matrix[row][k] -= factor * matrix[column][k];
+                vector[row] -= factor * vector[column];
+            }
+        }
+
+        for (int row = NUM_SHELVES - 1; row >= 0; --row)
+        {
+            for (int k = row + 1; k < NUM_SHELVES; ++k)
+                vector[row] -= matrix[row][k] * vector[k];
+            vector[row] /= matrix[row][row];
+        }
+    }
+}
+
+double PlaybackLoss::getLossDecibels(const Geometry& geometry, double frequency)
+{
+    const double pi = juce::MathConstants<double>::pi;
+    const double wavelength = geometry.speed / std::max(frequency, 1.0e-3) * 1.0e6;   // um
+
+    const double gapX = pi * geometry.gap / wavelength;
+    const double gap = gapX > 1.0e-9 ? std::abs(std::sin(gapX)) / gapX : 1.0;
+
+    const double spacingDb = -20.0 / std::log(10.0) * 2.0 * pi * geometry.spacing / wavelength;
+
+    const double thicknessX = 2.0 * pi * geometry.thickness / wavelength;
+    const double thickness = thicknessX > 1.0e-9 ? -std::expm1(-thicknessX) / thicknessX : 1.0;
+
+    // Gap nulls are floored; they lie above the audio band at real speeds
+    return 20.0 * std::log10(std::max(gap * thickness, 1.0e-6)) + spacingDb;
+}
+
+void PlaybackLoss::design(const Geometry& geometry, double sampleRate,
+                          TapeKernels::BiquadCoefficients (&sections)[NUM_SECTIONS])
+{
+    const double pi = juce::MathConstants<double>::pi;
+    const double nyquistLimit = 0.45 * sampleRate;
+
+    Shelf shelves[NUM_SHELVES];
+    double corner = LOWEST_CORNER;
+    for (auto& shelf : shelves)
+    {
+        shelf.warp = 1.0 / std::tan(pi * std::min(corner, nyquistLimit) / sampleRate);
+        corner *= CORNER_RATIO;
+    }
+
+    double cosOmega[NUM_POINTS], target[NUM_POINTS];
+    const double fitHigh = std::min(FIT_HIGH, nyquistLimit);
+    for (int i = 0; i < NUM_POINTS; ++i)
+    {
+        const double frequency = FIT_LOW * std::pow(fitHigh / FIT_LOW, i / (NUM_POINTS - 1.0));
+        cosOmega[i] = std::cos(2.0 * pi * frequency / sampleRate);
+        target[i] = getLossDecibels(geometry, frequency);
+    }
+
+    // Residuals (fit - target) and, optionally, their gradients
+    double gains[NUM_SHELVES] = {};
+    double residuals[NUM_POINTS], jacobian[NUM_POINTS][NUM_SHELVES];
+
+    const auto evaluate = [&](const double (&trial)[NUM_SHELVES], bool withJacobian)
+    {
+        for (int k = 0; k < NUM_SHELVES; ++k)
+            shelves[k].setGain(trial[k]);
+
+        double cost = 0.0;
+        for (int i = 0; i < NUM_POINTS; ++i)
+        {
+            double power = 1.0;
+            for (int k = 0; k < NUM_SHELVES; ++k)
+            {
+                double n, d;
+                shelves[k].getPower(cosOmega[i], n, d);
+                power *= n / d;
+                if (withJacobian)
+                    jacobian[i][k] = shelves[k].getSlope(cosOmega[i], n, d);
+            }
+
+            const double residual = 10.0 * std::log10(power) - target[i];
+            if (withJacobian)
+                residuals[i] = residual;
+            cost += residual * residual;
+        }
+        return cost;
+    };
+
+    // Levenberg-Marquardt: grow the damping until a step lowers the cost,
+    // stop when none does
+    double cost = evaluate(gains, true);
+    double damping = 0.01;
+
+    for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration)
+    {
+        double normal[NUM_SHELVES][NUM_SHELVES] = {}, gradient[NUM_SHELVES] = {};
+        for (int i = 0; i < NUM_POINTS; ++i)
+        {
+            for (int j = 0; j < NUM_SHELVES; ++j)
+            {
+                gradient[j] -= jacobian[i][j] * residuals[i];
+                for (int k = 0; k < NUM_SHELVES; ++k)
+                    normal[j][k] += jacobian[i][j] * jacobian[i][k];
+            }
+        }
+
+        bool improved = false;
+        for (int attempt = 0; attempt < 4 && ! improved; ++attempt)
+        {
+            double matrix[NUM_SHELVES][NUM_SHELVES], step[NUM_SHELVES];
+            for (int j = 0; j < NUM_SHELVES; ++j)
+            {
+                for (int k = 0; k < NUM_SHELVES; ++k)
+                    matrix[j][k] = normal[j][k];
+                matrix[j][j] += damping * normal[j][j] + 1.0e-9;
+                step[j] = gradient[j];
+            }
+
+            solve(matrix, step);
+
+            double trial[NUM_SHELVES];
+            for (int k = 0; k < NUM_SHELVES; ++k)
+                trial[k] = std::clamp(gains[k] + step[k], MIN_SHELF_GAIN, 0.0);
+
+            const double trialCost = evaluate(trial, false);
+            if (trialCost < cost)
+            {
+                std::copy(std::begin(trial), std::end(trial), std::begin(gains));
+                cost = evaluate(gains, true);
+                damping *= 0.3;
+                improved = true;
+            }
+            else
+            {
+                damping *= 10.0;
+            }
+        }
+
+        if (! improved)
+            break;
+    }
+
+    // Pair the shelves into biquads
+    for (int k = 0; k < NUM_SHELVES; ++k)
+        shelves[k].setGain(gains[k]);
+
+    for (int s = 0; s < NUM_SECTIONS; ++s)
+    {
+        const auto& first = shelves[2 * s];
+        const auto& second = shelves[2 * s + 1];
+        const double a0 = first.denominator[0] * second.denominator[0];
+
+        auto& coeffs = sections[s];
+        coeffs.b0 = static_cast<float>(first.numerator[0] * second.numerator[0] / a0);
+        coeffs.b1 = static_cast<float>((first.numerator[0] * second.numerator[1] + first.numerator[1] * second.numerator[0]) / a0);
+        coeffs.b2 = static_cast<float>(first.numerator[1] * second.numerator[1] / a0);
+        coeffs.a1 = static_cast<float>((first.denominator[0] * second.denominator[1] + first.denominator[1] * second.denominator[0]) / a0);
+        coeffs.a2 = static_cast<float>(first.denominator[1] * second.denominator[1] / a0);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "TapeKernels.h"
+
+// High-frequency losses of a reproduce head, which depend on the recorded
+// wavelength (tape speed / frequency) rather than on frequency alone:
+//
+//   gap loss        sin(x) / x,               x = pi * gap / wavelength
+//   spacing loss    exp(-x),                  x = 2 pi * spacing / wavelength
+//   thickness loss  (1 - exp(-x)) / x,        x = 2 pi * depth / wavelength
+//
+// design() fits their product with a cascade of biquads. The fit is in dB
+// over log-spaced frequencies up to 20 kHz: NUM_SECTIONS pairs of
+// first-order high shelves at fixed corners, whose gains are solved by a
+// few damped Gauss-Newton steps. It allocates nothing and takes bounded
+// time, so it runs on the audio thread when a control changes.
+namespace PlaybackLoss
+{
+    static constexpr int NUM_SECTIONS = TapeKernels::PLAYBACK_LOSS_SECTIONS;
+
+    // Tape speed and head/tape dimensions
+    struct Geometry
+    {
+        double speed = 0.381;           // m/s
+        double gap = 2.0;               // Playback head gap, um
+        double spacing = 0.5;           // Head-to-tape spacing, um
+        double thickness = 2.5;         // Recorded depth of the coating, um
+    };
+
+    // Combined loss at a frequency in dB (0 at DC, negative above)
+    double getLossDecibels(const Geometry& geometry, double frequency);
+
+    // Biquads in series approximating the loss at this rate, unity at DC
+    void design(const Geometry& geometry, double sampleRate, TapeKernels::BiquadCoefficients (&sections)[NUM_SECTIONS]);
+}
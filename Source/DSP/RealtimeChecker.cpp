@@ -0,0 +1,293 @@
+#include "RealtimeChecker.h"
+
+#if TAPEWARM_RT_CHECK
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr int MAX_REPORTS = 32;     // Full reports; later violations are only counted
+
+    thread_local int realtimeDepth = 0;
+    thread_local bool reporting = false;
+    std::atomic<int> numViolations { 0 };
+
+    void reportViolation(const char* what) noexcept
+    {
+        if (realtimeDepth == 0 || reporting)
+            return;
+
+        // Reporting allocates; suspend checking on this thread meanwhile
+        reporting = true;
+
+        if (numViolations.fetch_add(1) < MAX_REPORTS)
+        {
+            juce::Logger::outputDebugString(juce::String("TapeWarm realtime violation: ") + what
+                                            + " on the audio thread\n" + juce::SystemStats::getStackBacktrace());
+        }
+
+        reporting = false;
+    }
+
+    void* allocate(std::size_t size)
+    {
+        reportViolation("allocation");
+        return std::malloc(size != 0 ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        reportViolation("allocation");
+
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size != 0 ? size : 1, static_cast<std::size_t>(alignment));
+       #else
+        void* pointer = nullptr;
+        const auto bytes = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+        return posix_memalign(&pointer, bytes, size != 0 ? size : 1) == 0 ? pointer : nullptr;
+       #endif
+    }
+
+    void deallocate(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            reportViolation("deallocation");
+
+        std::free(pointer);
+    }
+
+    void deallocateAligned(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            reportViolation("deallocation");
+
+       #if JUCE_WINDOWS
+        _aligned_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+}
+
+namespace RealtimeChecker
+{
+    ScopedRealtime::ScopedRealtime() noexcept   { ++realtimeDepth; }
+    ScopedRealtime::~ScopedRealtime() noexcept  { --realtimeDepth; }
+
+    void checkBlockingCall(const char* what) noexcept
+    {
+        reportViolation(what);
+    }
+
+    int getNumViolations() noexcept
+    {
+        return numViolations.load();
+    }
+}
+
+#if JUCE_LINUX || JUCE_MAC
+//==============================================================================
+// Blocking libc functions, interposed for the calls this binary makes: JUCE's
+// locks, events and sleeps, and on Linux std::mutex and std::condition_variable,
+// whose inline code calls pthread directly. Each reports, then forwards to
+// the next definition
+
+namespace
+{
+    // Looked up on first use, without a lock: dlsym takes none of the ones
+    // interposed here, and racing threads store the same pointer
+    template <typename Function>
+    Function findNext(std::atomic<void*>& next, const char* name, const char* version = nullptr) noexcept
+    {
+        void* function = next.load(std::memory_order_acquire);
+
+        if (function == nullptr)
+        {
+           #if defined (__GLIBC__)
+            // Older versions of the condition variable functions are
+            // still exported under the default names on some platforms
+            if (version != nullptr)
+                function = dlvsym(RTLD_NEXT, name, version);
+           #else
+            juce::ignoreUnused(version);
+           #endif
+
+            if (function == nullptr)
+                function = dlsym(RTLD_NEXT, name);
+
+            next.store(function, std::memory_order_release);
+        }
+
+        return reinterpret_cast<Function>(function);
+    }
+}
+
+// glibc declares the lock functions noexcept in C++
+#if defined (__GLIBC__)
+ #define TAPEWARM_LIBC_NOEXCEPT noexcept
+#else
+ #define TAPEWARM_LIBC_NOEXCEPT
+#endif
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex) TAPEWARM_LIBC_NOEXCEPT
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("pthread_mutex_lock");
+        return findNext<decltype(&pthread_mutex_lock)>(next, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) TAPEWARM_LIBC_NOEXCEPT
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("pthread_rwlock_rdlock");
+        return findNext<decltype(&pthread_rwlock_rdlock)>(next, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) TAPEWARM_LIBC_NOEXCEPT
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("pthread_rwlock_wrlock");
+        return findNext<decltype(&pthread_rwlock_wrlock)>(next, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("pthread_cond_wait");
+        return findNext<decltype(&pthread_cond_wait)>(next, "pthread_cond_wait", "GLIBC_2.3.2")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* time)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("pthread_cond_timedwait");
+        return findNext<decltype(&pthread_cond_timedwait)>(next, "pthread_cond_timedwait", "GLIBC_2.3.2")(condition, mutex, time);
+    }
+
+    int pthread_join(pthread_t thread, void** result)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("pthread_join");
+        return findNext<decltype(&pthread_join)>(next, "pthread_join")(thread, result);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("sem_wait");
+        return findNext<decltype(&sem_wait)>(next, "sem_wait")(semaphore);
+    }
+
+    int nanosleep(const timespec* duration, timespec* remaining)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("nanosleep");
+        return findNext<decltype(&nanosleep)>(next, "nanosleep")(duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("usleep");
+        return findNext<decltype(&usleep)>(next, "usleep")(microseconds);
+    }
+
+    unsigned int sleep(unsigned int seconds)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("sleep");
+        return findNext<decltype(&sleep)>(next, "sleep")(seconds);
+    }
+
+    ssize_t write(int file, const void* data, size_t size)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("write");
+        return findNext<decltype(&write)>(next, "write")(file, data, size);
+    }
+
+   #if JUCE_LINUX
+    // What std::condition_variable waits with, from glibc 2.30
+    #if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30)
+    int pthread_cond_clockwait(pthread_cond_t* condition, pthread_mutex_t* mutex, clockid_t clock, const timespec* time)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("pthread_cond_clockwait");
+        return findNext<decltype(&pthread_cond_clockwait)>(next, "pthread_cond_clockwait")(condition, mutex, clock, time);
+    }
+    #endif
+
+    int clock_nanosleep(clockid_t clock, int flags, const timespec* time, timespec* remaining)
+    {
+        static std::atomic<void*> next { nullptr };
+        reportViolation("clock_nanosleep");
+        return findNext<decltype(&clock_nanosleep)>(next, "clock_nanosleep")(clock, flags, time, remaining);
+    }
+   #endif
+}
+
+#undef TAPEWARM_LIBC_NOEXCEPT
+#endif
+
+//==============================================================================
+// Global allocation functions, replaced for the whole binary
+
+void* operator new(std::size_t size)
+{
+    if (void* pointer = allocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept      { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept    { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = allocateAligned(size, alignment))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept    { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept  { return allocateAligned(size, alignment); }
+
+void operator delete(void* pointer) noexcept                                    { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept                                  { deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept                       { deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept                     { deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept             { deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept           { deallocate(pointer); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept                              { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept                            { deallocateAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept                 { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept               { deallocateAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept       { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept     { deallocateAligned(pointer); }
+
+#endif
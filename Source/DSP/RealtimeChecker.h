@@ -0,0 +1,51 @@
+#pragma once
+
+// QA builds only: configure with -DTAPEWARM_RT_CHECK=ON. Flags allocation,
+// deallocation and blocking calls made on a thread while it is inside
+// processBlock, with a stack trace; compiles to nothing otherwise.
+//
+// Seen everywhere: the global operator new/delete (replaced in this binary)
+// and calls marked with checkBlockingCall(). On Linux and macOS, calls this
+// binary makes to pthread locks, condition variable waits, joins,
+// semaphores, sleeps and write() are interposed too. That covers
+// juce::CriticalSection and JUCE's events and sleeps, and on Linux
+// std::mutex, whose inline code calls pthread here; on macOS std::mutex
+// locks inside the C++ library and is only seen where marked. Not
+// intercepted: malloc, free and realloc called directly, calls made from
+// inside other libraries, and on Windows any lock or system call that is
+// not marked. A clean run is therefore no proof that processBlock never
+// blocks.
+#ifndef TAPEWARM_RT_CHECK
+ #define TAPEWARM_RT_CHECK 0
+#endif
+
+namespace RealtimeChecker
+{
+#if TAPEWARM_RT_CHECK
+    // Marks the calling thread as realtime for the lifetime of the object
+    class ScopedRealtime
+    {
+    public:
+        ScopedRealtime() noexcept;
+        ~ScopedRealtime() noexcept;
+
+        ScopedRealtime(const ScopedRealtime&) = delete;
+        ScopedRealtime& operator=(const ScopedRealtime&) = delete;
+    };
+
+    // Call at the top of anything that can block (locks, waits, file I/O)
+    void checkBlockingCall(const char* what) noexcept;
+
+    // Violations seen so far in this process
+    int getNumViolations() noexcept;
+#else
+    class ScopedRealtime
+    {
+    public:
+        ScopedRealtime() noexcept {}
+    };
+
+    inline void checkBlockingCall(const char*) noexcept {}
+    inline int getNumViolations() noexcept { return 0; }
+#endif
+}
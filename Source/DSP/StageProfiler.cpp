@@ -0,0 +1,149 @@
+#include "StageProfiler.h"
+
+StageProfiler::StageProfiler()
+{
+    // Smallest gap between back-to-back clock reads: what each lap adds on
+    // top of the stage it times
+    int64_t smallest = INT64_MAX;
+    for (int i = 0; i < 64; ++i)
+    {
+        const auto start = now();
+        smallest = std::min(smallest, now() - start);
+    }
+
+    clockOverhead = smallest;
+}
+
+const char* StageProfiler::getStageName(int stage)
+{
+    switch (stage)
+    {
+        case Metering:      return "Metering";
+        case Control:       return "Control";
+        case DryDelay:      return "Dry delay";
+        case Saturation:    return "Saturation";
+        case HeadBump:      return "Head bump";
+        case FilterCascade: return "Filter cascade";
+        case WowFlutter:    return "Wow/flutter";
+        case HissMix:       return "Hiss/mix";
+        case Total:         return "Total";
+        default:            return "";
+    }
+}
+
+void StageProfiler::endBlock(int numSamples, double sampleRate) noexcept
+{
+    const auto clampNs = [](int64_t ns)
+    {
+        return static_cast<uint32_t>(std::clamp<int64_t>(ns, 0, UINT32_MAX));
+    };
+
+    int64_t total = 0;
+    for (size_t stage = 0; stage < blockTimes.size(); ++stage)
+    {
+        stages[stage].push(clampNs(blockTimes[stage]));
+        total += blockTimes[stage];
+    }
+
+    stages[Total].push(clampNs(total));
+    budget.push(clampNs(static_cast<int64_t>(numSamples * 1.0e9 / sampleRate)));
+}
+
+StageProfiler::Summary StageProfiler::getSummary(int stage) const noexcept
+{
+    Summary summary;
+    if (stage < 0 || stage > Total)
+        return summary;
+
+    const auto& histogram = stages[static_cast<size_t>(stage)];
+    summary.averageNs = histogram.getAverage();
+    summary.p99Ns = histogram.getPercentile(0.99);
+    summary.maxNs = histogram.getMax();
+
+    const double averageBudget = budget.getAverage();
+    summary.budgetShare = averageBudget > 0.0 ? summary.averageNs / averageBudget : 0.0;
+    return summary;
+}
+
+//==============================================================================
+void StageProfiler::RollingHistogram::push(uint32_t value) noexcept
+{
+    auto& slot = values[static_cast<size_t>(writeIndex)];
+
+    // Drop the value leaving the window
+    if (count.load(std::memory_order_relaxed) == WINDOW)
+    {
+        const auto old = slot.load(std::memory_order_relaxed);
+        counts[static_cast<size_t>(binOf(old))].fetch_sub(1, std::memory_order_relaxed);
+        sum.fetch_sub(old, std::memory_order_relaxed);
+    }
+    else
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    slot.store(value, std::memory_order_relaxed);
+    counts[static_cast<size_t>(binOf(value))].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    writeIndex = (writeIndex + 1) % WINDOW;
+}
+
+double StageProfiler::RollingHistogram::getAverage() const noexcept
+{
+    const int n = count.load(std::memory_order_relaxed);
+    return n > 0 ? static_cast<double>(sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+double StageProfiler::RollingHistogram::getPercentile(double fraction) const noexcept
+{
+    const int n = count.load(std::memory_order_relaxed);
+    if (n == 0)
+        return 0.0;
+
+    // Walk down from the slowest bin until the tail above the percentile is covered
+    const auto tail = static_cast<uint32_t>((1.0 - fraction) * n);
+    uint32_t seen = 0;
+
+    for (int bin = NUM_BINS - 1; bin >= 0; --bin)
+    {
+        seen += counts[static_cast<size_t>(bin)].load(std::memory_order_relaxed);
+        if (seen > tail)
+            return static_cast<double>(binLowerEdge(bin + 1));
+    }
+
+    return 0.0;
+}
+
+double StageProfiler::RollingHistogram::getMax() const noexcept
+{
+    const int n = count.load(std::memory_order_relaxed);
+    uint32_t maximum = 0;
+
+    for (int i = 0; i < n; ++i)
+        maximum = std::max(maximum, values[static_cast<size_t>(i)].load(std::memory_order_relaxed));
+
+    return static_cast<double>(maximum);
+}
+
+int StageProfiler::RollingHistogram::binOf(uint32_t value) noexcept
+{
+    // Two bins per octave: the highest set bit and the one below it
+    if (value < 2)
+        return static_cast<int>(value);
+
+    int highestBit = 0;
+    while ((value >> (highestBit + 1)) != 0)
+        ++highestBit;
+
+    return highestBit * 2 + static_cast<int>((value >> (highestBit - 1)) & 1);
+}
+
+uint64_t StageProfiler::RollingHistogram::binLowerEdge(int bin) noexcept
+{
+    if (bin < 2)
+        return static_cast<uint64_t>(bin);
+
+    const int highestBit = bin / 2;
+    return (uint64_t { 1 } << highestBit) | (static_cast<uint64_t>(bin & 1) << (highestBit - 1));
+}
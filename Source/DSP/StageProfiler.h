@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Diagnostics builds only: configure with -DTAPEWARM_PROFILING=ON. When off,
+// TAPEWARM_PROFILE() statements compile to nothing.
+#ifndef TAPEWARM_PROFILING
+ #define TAPEWARM_PROFILING 0
+#endif
+
+#if TAPEWARM_PROFILING
+ #define TAPEWARM_PROFILE(statement) statement
+#else
+ #define TAPEWARM_PROFILE(statement) ((void) 0)
+#endif
+
+// Per-stage timing of TapeProcessor::process.
+//
+// On every block the audio thread takes a timestamp after each stage and
+// charges the time since the previous one, less the cost of reading the
+// clock, to that stage. Every block is timed so that p99 and max catch the
+// one-off slow blocks a sampled profile would skip. At the end of the block
+// the per-stage totals go into rolling histograms covering the last WINDOW
+// blocks, which the editor reads without locking (single writer, relaxed
+// atomics; a summary may mix values from adjacent blocks).
+class StageProfiler
+{
+public:
+    enum Stage
+    {
+        Metering = 0,       // Level meters and dual-mono detection
+        Control,            // Control-rate ticks
+        DryDelay,
+        Saturation,         // Input gain, oversampling and saturation
+        HeadBump,           // Convolution or low band head bump
+        FilterCascade,      // De-emphasis, head bump biquad and head losses
+        WowFlutter,         // Delay times, modulated delay and channel mirroring
+        HissMix,            // Hiss, output gain and dry/wet mix
+        NumStages,
+        Total = NumStages   // Whole block, for getSummary()
+    };
+
+    StageProfiler();
+
+    static const char* getStageName(int stage);
+
+    struct Summary
+    {
+        double averageNs = 0.0;
+        double p99Ns = 0.0;         // Upper edge of the histogram bin
+        double maxNs = 0.0;
+        double budgetShare = 0.0;   // Average as a fraction of the average callback budget
+    };
+
+    //==============================================================================
+    // Audio thread
+
+    void beginBlock() noexcept
+    {
+        blockTimes.fill(0);
+        last = now();
+    }
+
+    void lap(Stage stage) noexcept
+    {
+        const auto time = now();
+        blockTimes[static_cast<size_t>(stage)] += std::max<int64_t>(0, time - last - clockOverhead);
+        last = time;
+    }
+
+    void endBlock(int numSamples, double sampleRate) noexcept;
+
+    //==============================================================================
+    // Any thread
+
+    Summary getSummary(int stage) const noexcept;
+    double getAverageBudgetNs() const noexcept { return budget.getAverage(); }
+
+private:
+    static int64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Counts of the last WINDOW values in half-octave bins, plus the values
+    // themselves for the sum and max
+    class RollingHistogram
+    {
+    public:
+        static constexpr int WINDOW = 1024;
+        static constexpr int NUM_BINS = 64;
+
+        void push(uint32_t value) noexcept;
+
+        double getAverage() const noexcept;
+        double getPercentile(double fraction) const noexcept;
+        double getMax() const noexcept;
+
+    private:
+        static int binOf(uint32_t value) noexcept;
+        static uint64_t binLowerEdge(int bin) noexcept;
+
+        std::array<std::atomic<uint32_t>, WINDOW> values {};
+        std::array<std::atomic<uint32_t>, NUM_BINS> counts {};
+        std::atomic<uint64_t> sum { 0 };
+        std::atomic<int> count { 0 };
+        int writeIndex = 0;
+    };
+
+    std::array<int64_t, NumStages> blockTimes {};
+    int64_t last = 0;
+    int64_t clockOverhead = 0;      // Cost of one now() call, measured at construction
+
+    std::array<RollingHistogram, NumStages + 1> stages;     // Last entry is Total
+    RollingHistogram budget;
+};
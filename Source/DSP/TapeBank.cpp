@@ -0,0 +1,397 @@
+#include "TapeBank.h"
+#include <cmath>
+
+namespace
+{
+    constexpr int roundUpToLanes(int count, int laneWidth)
+    {
+        return (count + laneWidth - 1) / laneWidth * laneWidth;
+    }
+}
+
+// Smoothed values and the targets they approach once per tile
+const TapeBank::SmoothedLane TapeBank::smoothedLanes[] = {
+    { InputGain, TargetInputGain, 1 },
+    { B0, TargetB0, 1 }, { B1, TargetB1, 1 }, { B2, TargetB2, 1 }, { A1, TargetA1, 1 }, { A2, TargetA2, 1 },
+    { LossB0, TargetLossB0, LOSS_SECTIONS }, { LossB1, TargetLossB1, LOSS_SECTIONS },
+    { LossB2, TargetLossB2, LOSS_SECTIONS }, { LossA1, TargetLossA1, LOSS_SECTIONS },
+    { LossA2, TargetLossA2, LOSS_SECTIONS },
+    { DryGain, TargetDryGain, 1 },
+    { WetGain, TargetWetGain, 1 }
+};
+
+TapeBank::TapeBank(int numChannelsToUse)
+    : models(TapeModelSet::acquire()),
+      numChannels(std::max(1, numChannelsToUse)),
+      settings(static_cast<size_t>(numChannels)),
+      channelLane(static_cast<size_t>(numChannels), 0)
+{
+    // Worst case: every curve group ends with a partly filled vector
+    maxLanes = roundUpToLanes(numChannels, LANE_WIDTH) + (NUM_CURVES - 1) * LANE_WIDTH;
+
+    const size_t laneFloats = static_cast<size_t>(NumLaneArrays + TILE_SIZE) * static_cast<size_t>(maxLanes);
+    constexpr size_t alignmentFloats = 16;  // One cache line of slack to align the base
+
+    laneStorage.allocate(laneFloats + alignmentFloats, true);
+    filterState.allocate(static_cast<size_t>(NumFilterArrays) * static_cast<size_t>(maxLanes), true);
+    noiseState.allocate(static_cast<size_t>(maxLanes), true);
+    scratch.allocate(static_cast<size_t>(maxLanes), true);
+    scratchSeeds.allocate(static_cast<size_t>(maxLanes), true);
+    scratchLanes.resize(static_cast<size_t>(numChannels));
+
+    auto address = reinterpret_cast<uintptr_t>(laneStorage.get());
+    laneData = laneStorage.get() + ((64 - (address & 63)) & 63) / sizeof(float);
+    tile = laneData + static_cast<size_t>(NumLaneArrays) * static_cast<size_t>(maxLanes);
+
+    lanes.inputGain = lane(InputGain);
+    lanes.bias = lane(Bias);
+    lanes.drive = lane(Drive);
+    lanes.hysteresisDrive = lane(HysteresisDrive);
+    lanes.hysteresisLag = lane(HysteresisLag);
+    lanes.b0 = lane(B0);
+    lanes.b1 = lane(B1);
+    lanes.b2 = lane(B2);
+    lanes.a1 = lane(A1);
+    lanes.a2 = lane(A2);
+    lanes.hissGain = lane(HissGain);
+    lanes.dryGain = lane(DryGain);
+    lanes.wetGain = lane(WetGain);
+    lanes.hysteresis = lane(Hysteresis);
+    lanes.hysteresisInput = lane(HysteresisInput);
+    lanes.x1 = filterLane(X1);
+    lanes.x2 = filterLane(X2);
+    lanes.y1 = filterLane(Y1);
+    lanes.y2 = filterLane(Y2);
+    lanes.noiseState = noiseState.get();
+
+    for (int s = 0; s < LOSS_SECTIONS; ++s)
+    {
+        lanes.lossB0[s] = lane(LossB0, s);
+        lanes.lossB1[s] = lane(LossB1, s);
+        lanes.lossB2[s] = lane(LossB2, s);
+        lanes.lossA1[s] = lane(LossA1, s);
+        lanes.lossA2[s] = lane(LossA2, s);
+        lanes.lossY1[s] = filterLane(LossY1, s);
+        lanes.lossY2[s] = filterLane(LossY2, s);
+    }
+
+    laneChannel.assign(static_cast<size_t>(maxLanes), -1);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        channelLane[static_cast<size_t>(ch)] = ch;
+        laneChannel[static_cast<size_t>(ch)] = ch;
+
+        // Fixed, distinct seeds: no system entropy needed per channel
+        noiseState[ch] = 0x9E3779B9u * static_cast<uint32_t>(ch + 1) | 1u;
+    }
+
+    updateLayout();
+}
+
+void TapeBank::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    kernels = &TapeKernels::selectKernels();
+
+    // Same ~10ms smoothing as TapeProcessor's control rate
+    smoothing = 1.0f - std::exp(-static_cast<float>(TILE_SIZE) / static_cast<float>(sampleRate * 0.01));
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        updateChannel(ch);
+
+    reset();
+}
+
+void TapeBank::reset()
+{
+    std::fill(lane(Hysteresis), lane(NumLaneArrays), 0.0f);
+    std::fill(filterLane(X1), filterLane(NumFilterArrays), 0.0);
+
+    // Start from the current targets rather than ramping from defaults
+    for (const auto& pair : smoothedLanes)
+        std::copy(lane(pair.target), lane(pair.target, pair.rows), lane(pair.current));
+
+    samplesUntilTick = 0;
+}
+
+void TapeBank::process(float* const* channelData, int numChannelsToProcess, int numSamples)
+{
+    jassert(numChannelsToProcess <= numChannels);
+    numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+
+    if (kernels == nullptr || numChannelsToProcess <= 0 || numSamples <= 0)
+        return;
+
+    if (layoutChanged)
+        updateLayout();
+
+    const int numLanes = groups[NUM_CURVES - 1].lastLane;
+
+    for (int start = 0; start < numSamples;)
+    {
+        if (samplesUntilTick == 0)
+        {
+            smoothParameters();
+            samplesUntilTick = TILE_SIZE;
+        }
+
+        const int tileLength = std::min(samplesUntilTick, numSamples - start);
+
+        // Interleave the planar input into the tile, one column per lane
+        for (int l = 0; l < numLanes; ++l)
+        {
+            const int ch = laneChannel[static_cast<size_t>(l)];
+            float* column = tile + l;
+
+            if (ch < 0 || ch >= numChannelsToProcess)
+            {
+                for (int i = 0; i < tileLength; ++i)
+                    column[i * maxLanes] = 0.0f;
+            }
+            else
+            {
+                const float* input = channelData[ch] + start;
+                for (int i = 0; i < tileLength; ++i)
+                    column[i * maxLanes] = input[i];
+            }
+        }
+
+        for (const auto& group : groups)
+            if (group.lastLane > group.firstLane)
+                kernels->bankTile(tile, tileLength, maxLanes, group.firstLane, group.lastLane, group.curve, lanes);
+
+        // Back to planar
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            const float* column = tile + channelLane[static_cast<size_t>(ch)];
+            float* output = channelData[ch] + start;
+            for (int i = 0; i < tileLength; ++i)
+                output[i] = column[i * maxLanes];
+        }
+
+        samplesUntilTick -= tileLength;
+        start += tileLength;
+    }
+}
+
+void TapeBank::smoothParameters()
+{
+    for (const auto& pair : smoothedLanes)
+    {
+        float* current = lane(pair.current);
+        const float* target = lane(pair.target);
+
+        for (int l = 0; l < maxLanes * pair.rows; ++l)
+            current[l] += smoothing * (target[l] - current[l]);
+    }
+}
+
+void TapeBank::setInputDrive(int channel, float dB)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].inputDrive = std::clamp(dB, -12.0f, 12.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setSaturation(int channel, float amount)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].saturation = std::clamp(amount, 0.0f, 100.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setWarmth(int channel, float amount)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].warmth = std::clamp(amount, 0.0f, 100.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setHeadBump(int channel, float amount)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].headBump = std::clamp(amount, 0.0f, 100.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setBumpFreq(int channel, float freq)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].bumpFreq = std::clamp(freq, 40.0f, 150.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setHiss(int channel, float amount)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].hiss = std::clamp(amount, 0.0f, 100.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setOutput(int channel, float dB)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].outputGain = std::clamp(dB, -12.0f, 12.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setMix(int channel, float amount)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].mix = std::clamp(amount, 0.0f, 100.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setAge(int channel, float amount)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].age = std::clamp(amount, 0.0f, 100.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setBias(int channel, float amount)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].bias = std::clamp(amount, 0.0f, 100.0f);
+    updateChannel(channel);
+}
+
+void TapeBank::setMachineType(int channel, int type)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].machineType = static_cast<MachineType>(std::clamp(type, 0, 2));
+    updateChannel(channel);
+}
+
+void TapeBank::setTapeType(int channel, int type)
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    settings[static_cast<size_t>(channel)].tapeType = static_cast<TapeType>(std::clamp(type, 0, 2));
+    updateChannel(channel);
+}
+
+TapeKernels::BankCurve TapeBank::getCurve(int channel) const
+{
+    const auto& channelSettings = settings[static_cast<size_t>(channel)];
+
+    if (channelSettings.saturation <= 0.0f)
+        return TapeKernels::BankCurve::Linear;
+
+    switch (channelSettings.tapeType)
+    {
+        case TapeType::TypeI:   return TapeKernels::BankCurve::Hysteresis;
+        case TapeType::TypeII:  return TapeKernels::BankCurve::Tanh;
+        case TapeType::Modern:  return TapeKernels::BankCurve::SoftKnee;
+    }
+
+    return TapeKernels::BankCurve::Linear;
+}
+
+void TapeBank::updateChannel(int channel)
+{
+    const auto& s = settings[static_cast<size_t>(channel)];
+    const int l = channelLane[static_cast<size_t>(channel)];
+
+    // The bank runs at the base rate with exact tanh
+    const auto& tapeModel = models->get(s.machineType, s.tapeType, QualityMode::Standard);
+
+    const float saturationAmount = s.saturation / 100.0f;
+    const float mixAmount = s.mix / 100.0f;
+
+    lane(Bias)[l] = (s.bias / 100.0f - 0.5f) * 0.1f;
+    lane(Drive)[l] = (1.0f + saturationAmount * 4.0f) * tapeModel.driveScale;
+    lane(HysteresisDrive)[l] = 1.0f + saturationAmount * 3.0f;
+
+    // Per half-sample step, as TapeProcessor scales it for 2x
+    lane(HysteresisLag)[l] = 1.0f - std::sqrt(1.0f - (0.3f + saturationAmount * 0.4f));
+
+    const float hissDb = DSPUtils::mapRange(s.hiss, 0.0f, 100.0f, -80.0f, -30.0f);
+    lane(HissGain)[l] = DSPUtils::decibelsToLinear(hissDb) * 0.7f;
+
+    const auto headBumpCoeffs = TapeProcessor::calculateHeadBumpCoefficients(
+        tapeModel, s.bumpFreq, s.headBump / 100.0f, currentSampleRate);
+
+    lane(TargetInputGain)[l] = DSPUtils::decibelsToLinear(s.inputDrive);
+    lane(TargetB0)[l] = headBumpCoeffs.b0;
+    lane(TargetB1)[l] = headBumpCoeffs.b1;
+    lane(TargetB2)[l] = headBumpCoeffs.b2;
+    lane(TargetA1)[l] = headBumpCoeffs.a1;
+    lane(TargetA2)[l] = headBumpCoeffs.a2;
+
+    TapeKernels::BiquadCoefficients loss[LOSS_SECTIONS];
+    TapeProcessor::calculatePlaybackLoss(tapeModel, s.warmth / 100.0f, s.age / 100.0f, currentSampleRate, loss);
+
+    for (int section = 0; section < LOSS_SECTIONS; ++section)
+    {
+        lane(TargetLossB0, section)[l] = loss[section].b0;
+        lane(TargetLossB1, section)[l] = loss[section].b1;
+        lane(TargetLossB2, section)[l] = loss[section].b2;
+        lane(TargetLossA1, section)[l] = loss[section].a1;
+        lane(TargetLossA2, section)[l] = loss[section].a2;
+    }
+
+    lane(TargetDryGain)[l] = 1.0f - mixAmount;
+    lane(TargetWetGain)[l] = DSPUtils::decibelsToLinear(s.outputGain) * mixAmount;
+
+    // A curve change moves the channel to another lane group
+    for (const auto& group : groups)
+        if (l >= group.firstLane && l < group.lastLane && group.curve != getCurve(channel))
+            layoutChanged = true;
+}
+
+void TapeBank::updateLayout()
+{
+    // Assign lanes group by group, padding each group to whole vectors
+    auto& newLane = scratchLanes;
+    int nextLane = 0;
+
+    for (int c = 0; c < NUM_CURVES; ++c)
+    {
+        const auto curve = static_cast<TapeKernels::BankCurve>(c);
+        groups[c].curve = curve;
+        groups[c].firstLane = nextLane;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            if (getCurve(ch) == curve)
+                newLane[static_cast<size_t>(ch)] = nextLane++;
+
+        nextLane = roundUpToLanes(nextLane, LANE_WIDTH);
+        groups[c].lastLane = nextLane;
+    }
+
+    // Move every per-lane value to its channel's new lane
+    for (int array = 0; array < NumLaneArrays; ++array)
+    {
+        float* data = lane(static_cast<LaneArray>(array));
+        std::copy(data, data + maxLanes, scratch.get());
+        std::fill(data, data + maxLanes, array == HysteresisDrive ? 1.0f : 0.0f);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            data[newLane[static_cast<size_t>(ch)]] = static_cast<float>(scratch[channelLane[static_cast<size_t>(ch)]]);
+    }
+
+    for (int array = 0; array < NumFilterArrays; ++array)
+    {
+        double* data = filterLane(static_cast<FilterArray>(array));
+        std::copy(data, data + maxLanes, scratch.get());
+        std::fill(data, data + maxLanes, 0.0);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            data[newLane[static_cast<size_t>(ch)]] = scratch[channelLane[static_cast<size_t>(ch)]];
+    }
+
+    std::copy(noiseState.get(), noiseState.get() + maxLanes, scratchSeeds.get());
+    std::fill(noiseState.get(), noiseState.get() + maxLanes, 1u);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        noiseState[newLane[static_cast<size_t>(ch)]] = scratchSeeds[channelLane[static_cast<size_t>(ch)]];
+
+    std::fill(laneChannel.begin(), laneChannel.end(), -1);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        channelLane[static_cast<size_t>(ch)] = newLane[static_cast<size_t>(ch)];
+        laneChannel[static_cast<size_t>(newLane[static_cast<size_t>(ch)])] = ch;
+    }
+
+    layoutChanged = false;
+}
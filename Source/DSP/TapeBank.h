@@ -0,0 +1,155 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TapeProcessor.h"
+#include <vector>
+
+// Tape chain for many channels at once (console-style inserts on every track).
+//
+// Channel state is held structure-of-arrays, one lane per channel, and the
+// kernel advances BANK_LANE_WIDTH channels per instruction. Lanes are grouped
+// by saturation curve so every vector runs a single code path, and each
+// group is padded to a whole number of vectors.
+//
+// The bank covers drive, saturation, head bump, head losses, hiss, output
+// gain and mix at the base rate (no oversampling). Type I's hysteresis is
+// integrated in half-sample steps, so each lane follows TapeProcessor at the
+// Standard tier. Wow/flutter needs a per-channel modulated delay read and
+// stays in TapeProcessor.
+class TapeBank
+{
+public:
+    explicit TapeBank(int numChannels);
+    ~TapeBank() = default;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // Processes planar buffers in place, one pointer per channel
+    void process(float* const* channelData, int numChannelsToProcess, int numSamples);
+
+    int getNumChannels() const { return numChannels; }
+
+    // Per-channel controls, same ranges as TapeProcessor
+    void setInputDrive(int channel, float dB);
+    void setSaturation(int channel, float amount);
+    void setWarmth(int channel, float amount);
+    void setHeadBump(int channel, float amount);
+    void setBumpFreq(int channel, float freq);
+    void setHiss(int channel, float amount);
+    void setOutput(int channel, float dB);
+    void setMix(int channel, float amount);
+    void setAge(int channel, float amount);
+    void setBias(int channel, float amount);
+    void setMachineType(int channel, int type);
+    void setTapeType(int channel, int type);
+
+private:
+    static constexpr int LANE_WIDTH = TapeKernels::BANK_LANE_WIDTH;
+    static constexpr int TILE_SIZE = 32;            // Samples per tile, also the smoothing tick
+    static constexpr int NUM_CURVES = 4;
+    static constexpr int LOSS_SECTIONS = PlaybackLoss::NUM_SECTIONS;
+
+    // Per-lane arrays; everything before TargetInputGain is read by the
+    // kernel, and the state array comes last. Head loss arrays have one row
+    // per section
+    enum LaneArray
+    {
+        InputGain = 0, Bias, Drive, HysteresisDrive, HysteresisLag,
+        B0, B1, B2, A1, A2,
+        LossB0, LossB1 = LossB0 + LOSS_SECTIONS, LossB2 = LossB1 + LOSS_SECTIONS,
+        LossA1 = LossB2 + LOSS_SECTIONS, LossA2 = LossA1 + LOSS_SECTIONS,
+        HissGain = LossA2 + LOSS_SECTIONS, DryGain, WetGain,
+        TargetInputGain, TargetB0, TargetB1, TargetB2, TargetA1, TargetA2,
+        TargetLossB0, TargetLossB1 = TargetLossB0 + LOSS_SECTIONS, TargetLossB2 = TargetLossB1 + LOSS_SECTIONS,
+        TargetLossA1 = TargetLossB2 + LOSS_SECTIONS, TargetLossA2 = TargetLossA1 + LOSS_SECTIONS,
+        TargetDryGain = TargetLossA2 + LOSS_SECTIONS, TargetWetGain,
+        Hysteresis, HysteresisInput,
+        NumLaneArrays
+    };
+
+    // Per-lane filter histories, kept in double like TapeProcessor's
+    // BiquadState
+    enum FilterArray
+    {
+        X1 = 0, X2, Y1, Y2,
+        LossY1, LossY2 = LossY1 + LOSS_SECTIONS,
+        NumFilterArrays = LossY2 + LOSS_SECTIONS
+    };
+
+    struct ChannelSettings
+    {
+        float inputDrive = 0.0f;        // dB
+        float saturation = 50.0f;       // 0-100
+        float warmth = 50.0f;           // 0-100
+        float headBump = 50.0f;         // 0-100
+        float bumpFreq = 80.0f;         // Hz
+        float hiss = 0.0f;              // 0-100
+        float outputGain = 0.0f;        // dB
+        float mix = 100.0f;             // 0-100
+        float age = 0.0f;               // 0-100
+        float bias = 50.0f;             // 0-100
+        MachineType machineType = MachineType::IPS_15;
+        TapeType tapeType = TapeType::TypeI;
+    };
+
+    struct SmoothedLane
+    {
+        LaneArray current;
+        LaneArray target;
+        int rows;
+    };
+
+    static const SmoothedLane smoothedLanes[];
+
+    struct LaneGroup
+    {
+        TapeKernels::BankCurve curve = TapeKernels::BankCurve::Linear;
+        int firstLane = 0;
+        int lastLane = 0;
+    };
+
+    float* lane(LaneArray array, int row = 0) const
+    {
+        return laneData + static_cast<size_t>(array + row) * static_cast<size_t>(maxLanes);
+    }
+
+    double* filterLane(FilterArray array, int row = 0) const
+    {
+        return filterState.get() + static_cast<size_t>(array + row) * static_cast<size_t>(maxLanes);
+    }
+
+    TapeKernels::BankCurve getCurve(int channel) const;
+    void updateChannel(int channel);
+    void updateLayout();
+    void smoothParameters();
+
+    std::shared_ptr<const TapeModelSet> models;
+
+    int numChannels = 0;
+    int maxLanes = 0;                   // Lanes allocated: every group padded to LANE_WIDTH
+
+    // Lane storage, NumLaneArrays rows of maxLanes floats, plus the
+    // TILE_SIZE x maxLanes interleaved tile; NumFilterArrays rows of
+    // maxLanes doubles
+    juce::HeapBlock<float> laneStorage;
+    juce::HeapBlock<double> filterState;
+    juce::HeapBlock<uint32_t> noiseState;
+    juce::HeapBlock<double> scratch;    // Used while regrouping lanes
+    juce::HeapBlock<uint32_t> scratchSeeds;
+    float* laneData = nullptr;
+    float* tile = nullptr;
+    TapeKernels::BankLanes lanes {};
+
+    std::vector<ChannelSettings> settings;
+    std::vector<int> channelLane;
+    std::vector<int> laneChannel;       // -1 for padding lanes
+    std::vector<int> scratchLanes;
+    LaneGroup groups[NUM_CURVES];
+    bool layoutChanged = false;
+
+    const TapeKernels::KernelTable* kernels = nullptr;
+    double currentSampleRate = 44100.0;
+    float smoothing = 1.0f;             // Per-tile interpolation coefficient
+    int samplesUntilTick = 0;
+};
@@ -0,0 +1,108 @@
+#include <JuceHeader.h>
+#include "TapeKernels.h"
+#include "DSPUtils.h"
+#include "TapeModel.h"
+#include <algorithm>
+#include <cmath>
+
+// x86 variants are built with per-function target options so the file can
+// be compiled without global ISA flags (including universal macOS builds)
+#if (defined (__x86_64__) || defined (__i386__)) && (defined (__GNUC__) || defined (__clang__))
+ #define TAPEWARM_KERNELS_X86 1
+#else
+ #define TAPEWARM_KERNELS_X86 0
+#endif
+
+#if defined (__aarch64__) || defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+ #define TAPEWARM_KERNELS_NEON 1
+#else
+ #define TAPEWARM_KERNELS_NEON 0
+#endif
+
+namespace TapeKernels
+{
+    // Baseline variant: SSE2 on x86-64, NEON on ARM64, plain scalar elsewhere
+    namespace Baseline
+    {
+        #include "TapeKernelsImpl.h"
+    }
+
+   #if TAPEWARM_KERNELS_X86
+    #if defined (__clang__)
+     #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+    #else
+     #pragma GCC push_options
+     #pragma GCC target ("avx2,fma")
+    #endif
+
+    namespace AVX2
+    {
+        #include "TapeKernelsImpl.h"
+    }
+
+    #if defined (__clang__)
+     #pragma clang attribute pop
+     #pragma clang attribute push (__attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma"))), apply_to = function)
+    #else
+     #pragma GCC pop_options
+     #pragma GCC push_options
+     #pragma GCC target ("avx512f,avx512dq,avx512vl,avx2,fma")
+    #endif
+
+    namespace AVX512
+    {
+        #include "TapeKernelsImpl.h"
+    }
+
+    #if defined (__clang__)
+     #pragma clang attribute pop
+    #else
+     #pragma GCC pop_options
+    #endif
+   #endif
+
+    static const KernelTable& getBaselineKernels()
+    {
+       #if TAPEWARM_KERNELS_NEON
+        return Baseline::getTable(InstructionSet::NEON, "NEON");
+       #elif TAPEWARM_KERNELS_X86 || defined (_M_X64)
+        return Baseline::getTable(InstructionSet::SSE2, "SSE2");
+       #else
+        return Baseline::getTable(InstructionSet::Scalar, "Scalar");
+       #endif
+    }
+
+    const KernelTable* getKernels(InstructionSet instructionSet)
+    {
+        const auto& baseline = getBaselineKernels();
+        if (instructionSet == baseline.instructionSet || instructionSet == InstructionSet::Scalar)
+            return &baseline;
+
+       #if TAPEWARM_KERNELS_X86
+        if (instructionSet == InstructionSet::AVX512
+             && juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX512DQ()
+             && juce::SystemStats::hasAVX512VL() && juce::SystemStats::hasFMA3())
+            return &AVX512::getTable(InstructionSet::AVX512, "AVX-512");
+
+        if (instructionSet == InstructionSet::AVX2
+             && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+            return &AVX2::getTable(InstructionSet::AVX2, "AVX2");
+       #endif
+
+        return nullptr;
+    }
+
+    const KernelTable& selectKernels()
+    {
+        static const KernelTable& selected = []() -> const KernelTable&
+        {
+            for (auto instructionSet : { InstructionSet::AVX512, InstructionSet::AVX2 })
+                if (auto* kernels = getKernels(instructionSet))
+                    return *kernels;
+
+            return getBaselineKernels();
+        }();
+
+        return selected;
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+// Hot DSP kernels compiled for several instruction sets and selected at
+// runtime from the CPU features, so one binary runs on every machine in
+// the fleet and still uses the widest vectors available.
+
+#include <cstdint>
+
+namespace TapeKernels
+{
+    struct BiquadCoefficients
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+        float a1 = 0.0f, a2 = 0.0f;
+    };
+
+    // Double precision: with float feedback, the rounding of a low bump's
+    // output recirculates at its ~1e4 DC noise gain, so two runs of the same
+    // input that started from different state never agree closer than 1e-4
+    struct BiquadState
+    {
+        double x1 = 0.0, x2 = 0.0;
+        double y1 = 0.0, y2 = 0.0;
+    };
+
+    // Longest series of biquads run in one pass by biquadCascade
+    static constexpr int MAX_CASCADE_SECTIONS = 4;
+
+    // Biquads fitted to the playback head losses (PlaybackLoss)
+    static constexpr int PLAYBACK_LOSS_SECTIONS = 2;
+
+    // TapeBank lanes are processed in groups of this many channels: one
+    // AVX-512 vector, or two AVX2 / four SSE2 / NEON vectors
+    static constexpr int BANK_LANE_WIDTH = 16;
+
+    // Saturation curve shared by every lane of a TapeBank group
+    enum class BankCurve
+    {
+        Linear = 0,     // Saturation off
+        Hysteresis,     // Ferric
+        Tanh,           // Chrome
+        SoftKnee        // Modern
+    };
+
+    // Structure-of-arrays view of TapeBank channels, one element per lane
+    struct BankLanes
+    {
+        // Parameters
+        const float* inputGain;
+        const float* bias;
+        const float* drive;
+        const float* hysteresisDrive;
+        const float* hysteresisLag;
+        const float* b0;
+        const float* b1;
+        const float* b2;
+        const float* a1;
+        const float* a2;
+        const float* lossB0[PLAYBACK_LOSS_SECTIONS];    // Head loss biquads, one row per section
+        const float* lossB1[PLAYBACK_LOSS_SECTIONS];
+        const float* lossB2[PLAYBACK_LOSS_SECTIONS];
+        const float* lossA1[PLAYBACK_LOSS_SECTIONS];
+        const float* lossA2[PLAYBACK_LOSS_SECTIONS];
+        const float* hissGain;
+        const float* dryGain;
+        const float* wetGain;
+
+        // State; the filter histories are double, as in BiquadState
+        float* hysteresis;
+        float* hysteresisInput;                         // Last input to the curve
+        double* x1;
+        double* x2;
+        double* y1;
+        double* y2;
+        double* lossY1[PLAYBACK_LOSS_SECTIONS];         // Each section's input history is the
+        double* lossY2[PLAYBACK_LOSS_SECTIONS];         // previous one's output history
+        uint32_t* noiseState;
+    };
+
+    // Instruction set a kernel table was compiled for
+    enum class InstructionSet
+    {
+        Scalar = 0,
+        SSE2,
+        AVX2,
+        AVX512,
+        NEON
+    };
+
+    // One set of hot kernels compiled for a particular instruction set
+    struct KernelTable
+    {
+        InstructionSet instructionSet;
+        const char* name;
+
+        // Memoryless saturation curves: y = f((x + offset) * drive)
+        void (*tanhSaturate)(float* data, int numSamples, float offset, float drive, bool fast);
+        void (*softKneeSaturate)(float* data, int numSamples, float offset, float drive, bool fast);
+
+        // Direct form I biquad and one-pole lowpass, in place
+        void (*biquad)(float* data, int numSamples, const BiquadCoefficients& coeffs, BiquadState& state);
+
+        // numSections (1 to MAX_CASCADE_SECTIONS) biquads in series, in place,
+        // in a single pass over the data
+        void (*biquadCascade)(float* data, int numSamples, const BiquadCoefficients* const* coeffs,
+                              BiquadState* const* states, int numSections);
+        void (*onePoleLowpass)(float* data, int numSamples, float coeff, float& state);
+
+        // Writes each sample into the circular delay line, then reads it back
+        // delays[i] samples behind the write head (linear or cubic interpolation)
+        void (*modulatedDelay)(float* data, float* delayLine, int delaySize, int writeIndex,
+                               const float* delays, int numSamples, bool cubic);
+
+        // data[i] += source[i] * gain
+        void (*addScaled)(float* data, const float* source, int numSamples, float gain);
+
+        // data[i] = dry[i] * dryGain + data[i] * wetGain
+        void (*mix)(float* data, const float* dry, int numSamples, float dryGain, float wetGain);
+
+        // accumulator += a * b over numComplex interleaved complex values
+        // (partitioned convolution)
+        void (*complexMultiplyAdd)(float* accumulator, const float* a, const float* b, int numComplex);
+
+        // Full TapeBank chain for lanes [firstLane, lastLane) of an
+        // interleaved tile, tile[sample * stride + lane], in place. The lane
+        // range is a multiple of BANK_LANE_WIDTH
+        void (*bankTile)(float* tile, int numSamples, int stride, int firstLane, int lastLane,
+                         BankCurve curve, const BankLanes& lanes);
+    };
+
+    // Best kernel table for the running CPU (detected once, then cached)
+    const KernelTable& selectKernels();
+
+    // Kernel table for a specific instruction set, or nullptr if this build
+    // or the running CPU does not support it
+    const KernelTable* getKernels(InstructionSet instructionSet);
+}
@@ -0,0 +1,381 @@
+// Kernel bodies shared by every instruction-set variant.
+//
+// This file is included several times by TapeKernels.cpp, each time inside a
+// different namespace and with different target options, so it must not
+// have an include guard or include any headers itself. The loops are kept
+// simple and branch-free so the compiler can auto-vectorise them for the
+// active target.
+
+static void tanhSaturate(float* data, int numSamples, float offset, float drive, bool fast)
+{
+    if (fast)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = DSPUtils::fastTanh((data[i] + offset) * drive);
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = DSPUtils::accurateTanh((data[i] + offset) * drive);
+    }
+}
+
+static void softKneeSaturate(float* data, int numSamples, float offset, float drive, bool fast)
+{
+    // Linear below 0.7, gentle tanh knee above
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float x = (data[i] + offset) * drive;
+        float magnitude = std::abs(x);
+        float excess = std::max(magnitude - 0.7f, 0.0f) * 2.0f;
+        float knee = 0.7f + (fast ? DSPUtils::fastTanh(excess) : DSPUtils::accurateTanh(excess)) * 0.3f;
+        float sign = (x > 0.0f) ? 1.0f : -1.0f;
+        data[i] = (magnitude > 0.7f) ? sign * knee : x;
+    }
+}
+
+static void biquad(float* data, int numSamples, const TapeKernels::BiquadCoefficients& coeffs,
+                   TapeKernels::BiquadState& state)
+{
+    double x1 = state.x1, x2 = state.x2;
+    double y1 = state.y1, y2 = state.y2;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double input = data[i];
+        const double output = coeffs.b0 * input + coeffs.b1 * x1 + coeffs.b2 * x2
+                            - coeffs.a1 * y1 - coeffs.a2 * y2;
+        x2 = x1;
+        x1 = input;
+        y2 = y1;
+        y1 = output;
+        data[i] = static_cast<float>(output);
+    }
+
+    state.x1 = x1;
+    state.x2 = x2;
+    state.y1 = y1;
+    state.y2 = y2;
+}
+
+// Sections in series with all their state held in registers; each sample
+// goes through every section before the next is loaded
+template <int numSections>
+static void biquadCascadeSections(float* data, int numSamples, const TapeKernels::BiquadCoefficients* const* coeffs,
+                                  TapeKernels::BiquadState* const* states)
+{
+    TapeKernels::BiquadCoefficients c[numSections];
+    TapeKernels::BiquadState z[numSections];
+
+    for (int k = 0; k < numSections; ++k)
+    {
+        c[k] = *coeffs[k];
+        z[k] = *states[k];
+    }
+
+    // Rounded to float once, after the last section
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double x = data[i];
+
+        for (int k = 0; k < numSections; ++k)
+        {
+            const double y = c[k].b0 * x + c[k].b1 * z[k].x1 + c[k].b2 * z[k].x2
+                           - c[k].a1 * z[k].y1 - c[k].a2 * z[k].y2;
+            z[k].x2 = z[k].x1;
+            z[k].x1 = x;
+            z[k].y2 = z[k].y1;
+            z[k].y1 = y;
+            x = y;
+        }
+
+        data[i] = static_cast<float>(x);
+    }
+
+    for (int k = 0; k < numSections; ++k)
+        *states[k] = z[k];
+}
+
+static_assert(TapeKernels::MAX_CASCADE_SECTIONS == 4, "biquadCascade needs a case per section count");
+
+static void biquadCascade(float* data, int numSamples, const TapeKernels::BiquadCoefficients* const* coeffs,
+                          TapeKernels::BiquadState* const* states, int numSections)
+{
+    switch (numSections)
+    {
+        case 1: biquadCascadeSections<1>(data, numSamples, coeffs, states); break;
+        case 2: biquadCascadeSections<2>(data, numSamples, coeffs, states); break;
+        case 3: biquadCascadeSections<3>(data, numSamples, coeffs, states); break;
+        case 4: biquadCascadeSections<4>(data, numSamples, coeffs, states); break;
+        default: break;
+    }
+}
+
+static void onePoleLowpass(float* data, int numSamples, float coeff, float& state)
+{
+    float z = state;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        z += coeff * (data[i] - z);
+        data[i] = z;
+    }
+
+    state = z;
+}
+
+static void modulatedDelay(float* data, float* delayLine, int delaySize, int writeIndex,
+                           const float* delays, int numSamples, bool cubic)
+{
+    const float size = static_cast<float>(delaySize);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        delayLine[writeIndex] = data[i];
+
+        // Fractional read position behind the write head
+        float readPos = static_cast<float>(writeIndex) - delays[i];
+        if (readPos < 0.0f)
+            readPos += size;
+
+        int index0 = static_cast<int>(readPos);
+        int index1 = (index0 + 1 == delaySize) ? 0 : index0 + 1;
+        float frac = readPos - static_cast<float>(index0);
+
+        if (cubic)
+        {
+            int indexM1 = (index0 == 0) ? delaySize - 1 : index0 - 1;
+            int index2 = (index1 + 1 == delaySize) ? 0 : index1 + 1;
+            data[i] = DSPUtils::hermiteInterpolate(delayLine[indexM1], delayLine[index0],
+                                                   delayLine[index1], delayLine[index2], frac);
+        }
+        else
+        {
+            data[i] = delayLine[index0] * (1.0f - frac) + delayLine[index1] * frac;
+        }
+
+        if (++writeIndex == delaySize)
+            writeIndex = 0;
+    }
+}
+
+static void addScaled(float* data, const float* source, int numSamples, float gain)
+{
+    for (int i = 0; i < numSamples; ++i)
+        data[i] += source[i] * gain;
+}
+
+static void mix(float* data, const float* dry, int numSamples, float dryGain, float wetGain)
+{
+    for (int i = 0; i < numSamples; ++i)
+        data[i] = dry[i] * dryGain + data[i] * wetGain;
+}
+
+static void complexMultiplyAdd(float* accumulator, const float* a, const float* b, int numComplex)
+{
+    // Interleaved (re, im) pairs
+    for (int i = 0; i < numComplex; ++i)
+    {
+        const float re = a[2 * i] * b[2 * i] - a[2 * i + 1] * b[2 * i + 1];
+        const float im = a[2 * i] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i];
+        accumulator[2 * i] += re;
+        accumulator[2 * i + 1] += im;
+    }
+}
+
+template <TapeKernels::BankCurve Curve>
+static void bankTileCurve(float* tile, int numSamples, int stride, int firstLane, int lastLane,
+                          const TapeKernels::BankLanes& lanes)
+{
+    constexpr int width = TapeKernels::BANK_LANE_WIDTH;
+    constexpr int lossSections = TapeKernels::PLAYBACK_LOSS_SECTIONS;
+
+    for (int base = firstLane; base < lastLane; base += width)
+    {
+        // Parameters and recursive state are copied into locals for the whole
+        // tile: they cannot alias the tile, and the fixed-width loops over
+        // lanes become a few vector ops per sample
+        float inputGain[width], bias[width], drive[width], hysteresisDrive[width], hysteresisLag[width];
+        float b0[width], b1[width], b2[width], a1[width], a2[width];
+        float lossB0[lossSections][width], lossB1[lossSections][width], lossB2[lossSections][width];
+        float lossA1[lossSections][width], lossA2[lossSections][width];
+        float hissGain[width], dryGain[width], wetGain[width];
+        float hysteresis[width], hysteresisInput[width];
+        double x1[width], x2[width], y1[width], y2[width];
+        double lossY1[lossSections][width], lossY2[lossSections][width];
+        uint32_t noise[width];
+
+        for (int l = 0; l < width; ++l)
+        {
+            inputGain[l] = lanes.inputGain[base + l];
+            bias[l] = lanes.bias[base + l];
+            drive[l] = lanes.drive[base + l];
+            hysteresisDrive[l] = lanes.hysteresisDrive[base + l];
+            hysteresisLag[l] = lanes.hysteresisLag[base + l];
+            b0[l] = lanes.b0[base + l];
+            b1[l] = lanes.b1[base + l];
+            b2[l] = lanes.b2[base + l];
+            a1[l] = lanes.a1[base + l];
+            a2[l] = lanes.a2[base + l];
+            hissGain[l] = lanes.hissGain[base + l];
+            dryGain[l] = lanes.dryGain[base + l];
+            wetGain[l] = lanes.wetGain[base + l];
+
+            hysteresis[l] = lanes.hysteresis[base + l];
+            hysteresisInput[l] = lanes.hysteresisInput[base + l];
+            x1[l] = lanes.x1[base + l];
+            x2[l] = lanes.x2[base + l];
+            y1[l] = lanes.y1[base + l];
+            y2[l] = lanes.y2[base + l];
+            noise[l] = lanes.noiseState[base + l];
+
+            for (int s = 0; s < lossSections; ++s)
+            {
+                lossB0[s][l] = lanes.lossB0[s][base + l];
+                lossB1[s][l] = lanes.lossB1[s][base + l];
+                lossB2[s][l] = lanes.lossB2[s][base + l];
+                lossA1[s][l] = lanes.lossA1[s][base + l];
+                lossA2[s][l] = lanes.lossA2[s][base + l];
+                lossY1[s][l] = lanes.lossY1[s][base + l];
+                lossY2[s][l] = lanes.lossY2[s][base + l];
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = tile + i * stride + base;
+            float saturated[width];
+
+            // 1. Saturation, in float; kept apart from the double filters
+            // below, so that each loop vectorizes on its own
+            for (int l = 0; l < width; ++l)
+            {
+                float y = frame[l] * inputGain[l];
+
+                if constexpr (Curve == TapeKernels::BankCurve::Hysteresis)
+                {
+                    // Two half-sample steps, the first from the midpoint of
+                    // the input, as TapeProcessor integrates at the
+                    // Standard tier's 2x
+                    const float x = (y + bias[l]) * drive[l];
+                    const float midpoint = 0.5f * (x + hysteresisInput[l]);
+                    hysteresisInput[l] = x;
+
+                    for (const float input : { midpoint, x })
+                    {
+                        const float diff = (input - hysteresis[l]) * hysteresisDrive[l];
+                        hysteresis[l] += DSPUtils::accurateTanh(diff) / hysteresisDrive[l] * hysteresisLag[l];
+                    }
+
+                    y = hysteresis[l] * TapeCharacteristics::tapes[static_cast<int>(TapeType::TypeI)].compensation;
+                }
+                else if constexpr (Curve == TapeKernels::BankCurve::Tanh)
+                {
+                    y = DSPUtils::accurateTanh((y + bias[l]) * drive[l]);
+                }
+                else if constexpr (Curve == TapeKernels::BankCurve::SoftKnee)
+                {
+                    // Same curve as softKneeSaturate, written without a branch
+                    const float x = (y + bias[l]) * drive[l];
+                    const float magnitude = std::abs(x);
+                    const float shaped = std::min(magnitude, 0.7f)
+                                       + DSPUtils::accurateTanh(std::max(magnitude - 0.7f, 0.0f) * 2.0f) * 0.3f;
+                    y = std::copysign(shaped, x);
+                }
+
+                saturated[l] = y;
+            }
+
+            for (int l = 0; l < width; ++l)
+            {
+                const float dry = frame[l];
+                const double y = saturated[l];
+
+                // 2. Head bump, in double like the biquad kernels: the
+                // bump's poles sit close to DC and amplify float rounding
+                const double bumped = b0[l] * y + b1[l] * x1[l] + b2[l] * x2[l] - a1[l] * y1[l] - a2[l] * y2[l];
+
+                // 3. Head losses: direct form I sections in series, each
+                // reading the previous one's output history as its input's
+                double lossed = bumped, input1 = y1[l], input2 = y2[l];
+                for (int s = 0; s < lossSections; ++s)
+                {
+                    const double output = lossB0[s][l] * lossed + lossB1[s][l] * input1 + lossB2[s][l] * input2
+                                        - lossA1[s][l] * lossY1[s][l] - lossA2[s][l] * lossY2[s][l];
+                    input1 = lossY1[s][l];
+                    input2 = lossY2[s][l];
+                    lossY2[s][l] = lossY1[s][l];
+                    lossY1[s][l] = output;
+                    lossed = output;
+                }
+
+                x2[l] = x1[l];
+                x1[l] = y;
+                y2[l] = y1[l];
+                y1[l] = bumped;
+
+                // 4. Hiss (per-lane xorshift32)
+                uint32_t n = noise[l];
+                n ^= n << 13;
+                n ^= n >> 17;
+                n ^= n << 5;
+                noise[l] = n;
+                const float hissSample = static_cast<float>(static_cast<int32_t>(n)) * (1.0f / 2147483648.0f);
+
+                // Output gain and dry/wet mix
+                frame[l] = dry * dryGain[l] + (static_cast<float>(lossed) + hissSample * hissGain[l]) * wetGain[l];
+            }
+        }
+
+        for (int l = 0; l < width; ++l)
+        {
+            lanes.hysteresis[base + l] = hysteresis[l];
+            lanes.hysteresisInput[base + l] = hysteresisInput[l];
+            lanes.x1[base + l] = x1[l];
+            lanes.x2[base + l] = x2[l];
+            lanes.y1[base + l] = y1[l];
+            lanes.y2[base + l] = y2[l];
+            lanes.noiseState[base + l] = noise[l];
+
+            for (int s = 0; s < lossSections; ++s)
+            {
+                lanes.lossY1[s][base + l] = lossY1[s][l];
+                lanes.lossY2[s][base + l] = lossY2[s][l];
+            }
+        }
+    }
+}
+
+static void bankTile(float* tile, int numSamples, int stride, int firstLane, int lastLane,
+                     TapeKernels::BankCurve curve, const TapeKernels::BankLanes& lanes)
+{
+    switch (curve)
+    {
+        case TapeKernels::BankCurve::Linear:
+            bankTileCurve<TapeKernels::BankCurve::Linear>(tile, numSamples, stride, firstLane, lastLane, lanes);
+            break;
+        case TapeKernels::BankCurve::Hysteresis:
+            bankTileCurve<TapeKernels::BankCurve::Hysteresis>(tile, numSamples, stride, firstLane, lastLane, lanes);
+            break;
+        case TapeKernels::BankCurve::Tanh:
+            bankTileCurve<TapeKernels::BankCurve::Tanh>(tile, numSamples, stride, firstLane, lastLane, lanes);
+            break;
+        case TapeKernels::BankCurve::SoftKnee:
+            bankTileCurve<TapeKernels::BankCurve::SoftKnee>(tile, numSamples, stride, firstLane, lastLane, lanes);
+            break;
+    }
+}
+
+static const TapeKernels::KernelTable& getTable(TapeKernels::InstructionSet instructionSet, const char* name)
+{
+    static const TapeKernels::KernelTable table {
+        instructionSet, name,
+        tanhSaturate, softKneeSaturate,
+        biquad, biquadCascade, onePoleLowpass,
+        modulatedDelay,
+        addScaled, mix,
+        complexMultiplyAdd,
+        bankTile
+    };
+    return table;
+}
@@ -0,0 +1,101 @@
+#include "TapeModel.h"
+#include "RealtimeChecker.h"
+#include <JuceHeader.h>
+#include <mutex>
+
+namespace
+{
+    // Profile names, in enum order
+    const char* const machineNames[] = { "7.5ips", "15ips", "30ips" };
+    const char* const tapeNames[] = { "typeI", "typeII", "modern" };
+
+    // Numeric property of a profile object, if present, limited to a range
+    // the filters and LFOs stay well behaved in
+    void readProperty(const juce::var& object, const char* name, float minimum, float maximum, float& value)
+    {
+        const auto& property = object[name];
+        if (property.isInt() || property.isInt64() || property.isDouble())
+            value = juce::jlimit(minimum, maximum, static_cast<float>(static_cast<double>(property)));
+    }
+}
+
+std::shared_ptr<const TapeModelSet> TapeModelSet::acquire()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<const TapeModelSet> shared;
+
+    RealtimeChecker::checkBlockingCall("TapeModelSet::acquire lock");
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto models = shared.lock();
+    if (models == nullptr)
+    {
+        models = std::shared_ptr<const TapeModelSet>(new TapeModelSet());
+        shared = models;
+    }
+
+    return models;
+}
+
+TapeModelSet::TapeModelSet()
+{
+    for (int m = 0; m < NUM_MACHINE_TYPES; ++m)
+        for (int t = 0; t < NUM_TAPE_TYPES; ++t)
+            for (int q = 0; q < NUM_QUALITY_MODES; ++q)
+                models[m][t][q] = TapeCharacteristics::builtInModels.models[m][t][q];
+
+    profileApplied = applyProfile();
+}
+
+bool TapeModelSet::applyProfile()
+{
+    const auto file = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                          .getChildFile("TapeWarm").getChildFile("Profile.json");
+    if (! file.existsAsFile())
+        return false;
+
+    const auto profile = juce::JSON::parse(file);
+    const auto& version = profile["version"];
+    if (! profile.isObject() || ! (version.isInt() || version.isInt64() || version.isDouble())
+        || static_cast<int>(version) < 1 || static_cast<int>(version) > PROFILE_VERSION)
+        return false;
+
+    const auto& machines = profile["machines"];
+    const auto& tapes = profile["tapes"];
+
+    for (int m = 0; m < NUM_MACHINE_TYPES; ++m)
+    {
+        const auto& machine = machines[machineNames[m]];
+        const auto& wow = machine["wow"];
+        const auto& flutter = machine["flutter"];
+
+        for (int t = 0; t < NUM_TAPE_TYPES; ++t)
+        {
+            const auto& tape = tapes[tapeNames[t]];
+
+            for (int q = 0; q < NUM_QUALITY_MODES; ++q)
+            {
+                auto& model = models[m][t][q];
+
+                readProperty(machine, "bumpSpeed", 0.25f, 4.0f, model.bumpSpeedMultiplier);
+                readProperty(machine, "bumpQ", 0.3f, 6.0f, model.bumpQ);
+                readProperty(machine, "gap", 0.25f, 10.0f, model.gapWidth);
+                readProperty(machine, "spacing", 0.0f, 5.0f, model.headSpacing);
+                readProperty(wow, "rate", 0.05f, 5.0f, model.wowRate);
+                readProperty(wow, "spread", 0.0f, 5.0f, model.wowRateSpread);
+                readProperty(wow, "depth", 0.0f, 4.0f, model.wowDepthScale);
+                readProperty(flutter, "rate", 2.0f, 50.0f, model.flutterRate);
+                readProperty(flutter, "spread", 0.0f, 20.0f, model.flutterRateSpread);
+                readProperty(flutter, "depth", 0.0f, 4.0f, model.flutterDepthScale);
+
+                readProperty(tape, "bumpGain", 0.0f, 3.0f, model.bumpGain);
+                readProperty(tape, "thickness", 0.25f, 15.0f, model.coatingThickness);
+                readProperty(tape, "drive", 0.1f, 4.0f, model.driveScale);
+
+                model.compile();
+            }
+        }
+    }
+
+    return true;
+}
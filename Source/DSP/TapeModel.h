@@ -0,0 +1,305 @@
+#pragma once
+
+#include <memory>
+
+// Machine speed types
+enum class MachineType
+{
+    IPS_7_5 = 0,   // 7.5 IPS - warmest, most head bump
+    IPS_15,         // 15 IPS - balanced
+    IPS_30          // 30 IPS - cleanest, most extended
+};
+
+// Tape formulation types
+enum class TapeType
+{
+    TypeI = 0,      // Ferric - classic warm, more saturation
+    TypeII,         // Chrome - brighter, cleaner
+    Modern          // Modern formulation - extended response
+};
+
+// Processing quality tiers (CPU vs fidelity across the whole chain)
+enum class QualityMode
+{
+    Eco = 0,        // Fast tanh, linear interpolation, no oversampling
+    Standard,       // Exact tanh, linear interpolation, 2x oversampling
+    HQ              // Exact tanh, cubic interpolation, 4x oversampling, sub-stepped hysteresis
+};
+
+// Anti-aliasing of the memoryless saturation curves (Type II, Modern)
+enum class AntialiasingMode
+{
+    Oversampling = 0,   // The quality tier's oversampling
+    ADAA1,              // First-order antiderivative anti-aliasing at 1x
+    ADAA2               // Second-order antiderivative anti-aliasing at 1x (one sample latency)
+};
+
+// Machine playback response engine
+enum class ResponseMode
+{
+    Filters = 0,        // Head bump biquad
+    Convolution         // Measured (or modelled) machine impulse response
+};
+
+// Record pre-emphasis and matching playback de-emphasis around the
+// saturation stage, so the tape saturates frequency-dependently
+enum class EmphasisMode
+{
+    Off = 0,
+    NAB,                // 3180 + 50 us (17.5 us at 30 IPS)
+    IEC                 // IEC/CCIR: 70, 35 or 17.5 us by speed
+};
+
+// Read-only characteristics of one machine/tape/quality combination
+struct TapeModel
+{
+    MachineType machineType = MachineType::IPS_15;
+    TapeType tapeType = TapeType::TypeI;
+    QualityMode quality = QualityMode::Standard;
+
+    // Tape speed and playback head
+    float tapeSpeed = 0.381f;           // m/s
+    float bumpSpeedMultiplier = 1.0f;   // Scales the head bump frequency
+    float bumpQ = 1.5f;
+    float gapWidth = 2.0f;              // Playback head gap, um
+    float headSpacing = 0.5f;           // Head-to-tape spacing, um, before age
+
+    // Transport: LFO rates are base + random * spread, depths scale the Wow and Flutter controls
+    float wowRate = 0.5f;               // Hz
+    float wowRateSpread = 0.5f;
+    float wowDepthScale = 1.0f;
+    float flutterRate = 10.0f;          // Hz
+    float flutterRateSpread = 5.0f;
+    float flutterDepthScale = 1.0f;
+
+    // Tape formulation
+    float bumpGain = 1.0f;              // Scales the head bump boost
+    float coatingThickness = 2.5f;      // Recorded depth of the coating, um, before warmth
+    float driveScale = 1.0f;            // Saturation drive
+    float compensation = 1.0f;          // Saturation output gain
+
+    // Quality tier
+    int oversamplingFactor = 1;
+    int hysteresisSteps = 1;            // Sub-steps per hysteresis update
+    bool fastTanh = false;
+    bool cubicInterpolation = false;    // Wow/flutter delay reads
+
+    // Per-combination constants, derived from the above by compile()
+    float bumpMaxGainDb = 6.0f;         // Head bump boost at Head Bump 100%
+
+    static constexpr float MAX_BUMP_GAIN_DB = 6.0f;    // At bumpGain 1
+
+    constexpr void compile()
+    {
+        bumpMaxGainDb = MAX_BUMP_GAIN_DB * bumpGain;
+    }
+};
+
+// Built-in characteristics, indexed by the enums, and every combination of
+// them compiled into a TapeModel at compile time
+namespace TapeCharacteristics
+{
+    constexpr int NUM_MACHINE_TYPES = 3;
+    constexpr int NUM_TAPE_TYPES = 3;
+    constexpr int NUM_QUALITY_MODES = 3;
+
+    constexpr float IPS = 0.0254f;      // m/s per inch per second
+
+    // Head bump frequency and HF losses vary with tape speed: the playback
+    // losses depend on the recorded wavelength, so the same head loses less
+    // at higher speeds. The slower machines also have wider, older heads
+    struct Machine
+    {
+        float tapeSpeed, bumpSpeedMultiplier, bumpQ, gapWidth, headSpacing;
+        float wowRate, wowRateSpread, flutterRate, flutterRateSpread;
+    };
+
+    inline constexpr Machine machines[NUM_MACHINE_TYPES] =
+    {
+        {  7.5f * IPS, 0.7f, 1.5f, 3.0f, 0.6f, 0.5f, 0.5f, 10.0f, 5.0f },   // 7.5 IPS: lower bump, darker
+        { 15.0f * IPS, 1.0f, 1.5f, 2.0f, 0.5f, 0.5f, 0.5f, 10.0f, 5.0f },   // 15 IPS: reference
+        { 30.0f * IPS, 1.5f, 1.5f, 1.5f, 0.4f, 0.5f, 0.5f, 10.0f, 5.0f }    // 30 IPS: higher bump, brighter
+    };
+
+    struct Tape
+    {
+        float bumpGain, coatingThickness, driveScale, compensation;
+    };
+
+    inline constexpr Tape tapes[NUM_TAPE_TYPES] =
+    {
+        { 1.2f, 2.5f, 1.3f, 0.8f },     // Ferric: pronounced bump, thick coating, more saturation
+        { 0.9f, 2.0f, 0.9f, 1.0f },     // Chrome: subtler, cleaner
+        { 0.7f, 1.5f, 0.7f, 1.0f }      // Modern: minimal bump, thin coating, most headroom
+    };
+
+    // Equalisation time constants in microseconds, by standard and speed;
+    // a low time constant of 0 means no low-frequency term
+    constexpr int NUM_EMPHASIS_STANDARDS = 2;
+
+    struct Emphasis
+    {
+        float lowTimeConstant, highTimeConstant;
+    };
+
+    inline constexpr Emphasis emphases[NUM_EMPHASIS_STANDARDS][NUM_MACHINE_TYPES] =
+    {
+        { { 3180.0f, 50.0f }, { 3180.0f, 50.0f }, { 0.0f, 17.5f } },   // NAB (AES at 30 IPS)
+        { { 0.0f, 70.0f },    { 0.0f, 35.0f },    { 0.0f, 17.5f } }    // IEC/CCIR
+    };
+
+    // Standard for an emphasis mode other than Off
+    constexpr const Emphasis& getEmphasis(EmphasisMode mode, MachineType machineType)
+    {
+        return emphases[static_cast<int>(mode) - 1][static_cast<int>(machineType)];
+    }
+
+    struct Quality
+    {
+        int oversamplingFactor, hysteresisSteps;
+        bool fastTanh, cubicInterpolation;
+    };
+
+    inline constexpr Quality qualities[NUM_QUALITY_MODES] =
+    {
+        { 1, 1, true,  false },         // Eco
+        { 2, 1, false, false },         // Standard
+        { 4, 4, false, true }           // HQ
+    };
+
+    constexpr TapeModel makeModel(int m, int t, int q)
+    {
+        const auto& machine = machines[m];
+        const auto& tape = tapes[t];
+        const auto& tier = qualities[q];
+
+        TapeModel model;
+        model.machineType = static_cast<MachineType>(m);
+        model.tapeType = static_cast<TapeType>(t);
+        model.quality = static_cast<QualityMode>(q);
+
+        model.tapeSpeed = machine.tapeSpeed;
+        model.bumpSpeedMultiplier = machine.bumpSpeedMultiplier;
+        model.bumpQ = machine.bumpQ;
+        model.gapWidth = machine.gapWidth;
+        model.headSpacing = machine.headSpacing;
+        model.wowRate = machine.wowRate;
+        model.wowRateSpread = machine.wowRateSpread;
+        model.flutterRate = machine.flutterRate;
+        model.flutterRateSpread = machine.flutterRateSpread;
+
+        model.bumpGain = tape.bumpGain;
+        model.coatingThickness = tape.coatingThickness;
+        model.driveScale = tape.driveScale;
+        model.compensation = tape.compensation;
+
+        model.oversamplingFactor = tier.oversamplingFactor;
+        model.hysteresisSteps = tier.hysteresisSteps;
+        model.fastTanh = tier.fastTanh;
+        model.cubicInterpolation = tier.cubicInterpolation;
+
+        model.compile();
+        return model;
+    }
+
+    struct ModelTable
+    {
+        TapeModel models[NUM_MACHINE_TYPES][NUM_TAPE_TYPES][NUM_QUALITY_MODES];
+
+        constexpr const TapeModel& get(MachineType machineType, TapeType tapeType, QualityMode quality) const
+        {
+            return models[static_cast<int>(machineType)][static_cast<int>(tapeType)][static_cast<int>(quality)];
+        }
+    };
+
+    constexpr ModelTable makeModelTable()
+    {
+        ModelTable table {};
+        for (int m = 0; m < NUM_MACHINE_TYPES; ++m)
+            for (int t = 0; t < NUM_TAPE_TYPES; ++t)
+                for (int q = 0; q < NUM_QUALITY_MODES; ++q)
+                    table.models[m][t][q] = makeModel(m, t, q);
+        return table;
+    }
+
+    inline constexpr ModelTable builtInModels = makeModelTable();
+
+    // The tables follow the enums
+    static_assert(static_cast<int>(MachineType::IPS_30) == NUM_MACHINE_TYPES - 1);
+    static_assert(static_cast<int>(TapeType::Modern) == NUM_TAPE_TYPES - 1);
+    static_assert(static_cast<int>(QualityMode::HQ) == NUM_QUALITY_MODES - 1);
+    static_assert(static_cast<int>(EmphasisMode::IEC) == NUM_EMPHASIS_STANDARDS);
+    static_assert(builtInModels.get(MachineType::IPS_30, TapeType::Modern, QualityMode::HQ).machineType == MachineType::IPS_30);
+    static_assert(builtInModels.get(MachineType::IPS_7_5, TapeType::TypeII, QualityMode::Eco).tapeType == TapeType::TypeII);
+
+    // Faster tape: higher head bump, less HF loss
+    static_assert(machines[0].tapeSpeed < machines[1].tapeSpeed && machines[1].tapeSpeed < machines[2].tapeSpeed);
+    static_assert(machines[0].bumpSpeedMultiplier < machines[1].bumpSpeedMultiplier
+                  && machines[1].bumpSpeedMultiplier < machines[2].bumpSpeedMultiplier);
+    static_assert(machines[0].gapWidth >= machines[1].gapWidth && machines[1].gapWidth >= machines[2].gapWidth);
+    static_assert(machines[0].headSpacing >= machines[1].headSpacing && machines[1].headSpacing >= machines[2].headSpacing);
+    static_assert(emphases[1][0].highTimeConstant > emphases[1][1].highTimeConstant
+                  && emphases[1][1].highTimeConstant > emphases[1][2].highTimeConstant);
+
+    // Ferric saturates hardest and has the biggest bump, Modern the least
+    static_assert(tapes[0].driveScale > tapes[1].driveScale && tapes[1].driveScale > tapes[2].driveScale);
+    static_assert(tapes[0].bumpGain > tapes[1].bumpGain && tapes[1].bumpGain > tapes[2].bumpGain);
+    static_assert(tapes[0].coatingThickness > tapes[1].coatingThickness
+                  && tapes[1].coatingThickness > tapes[2].coatingThickness);
+
+    // Compiled constants stay inside what the filters clamp to
+    static_assert(builtInModels.get(MachineType::IPS_15, TapeType::TypeI, QualityMode::Eco).bumpMaxGainDb <= 12.0f);
+
+    // Each tier costs at least as much as the one below
+    static_assert(qualities[0].oversamplingFactor <= qualities[1].oversamplingFactor
+                  && qualities[1].oversamplingFactor <= qualities[2].oversamplingFactor);
+}
+
+// Every TapeModel, shared by all processors in the process so instances
+// only hold their mutable state. The first acquire() builds the set and it
+// is freed when the last holder lets go; lookups are plain array indexing,
+// so they are safe on the audio thread.
+//
+// Building the set copies the built-in models and applies the profile
+// file, if there is one, over them: "<user app data>/TapeWarm/Profile.json", e.g.
+//
+//   { "version": 1,
+//     "machines": { "15ips": { "bumpSpeed": 1.1, "gap": 1.8,
+//                              "flutter": { "rate": 8, "spread": 2, "depth": 0.7 } } },
+//     "tapes":    { "typeI": { "bumpGain": 1.3, "drive": 1.4 } } }
+//
+// Machines are "7.5ips", "15ips" and "30ips" (bumpSpeed, bumpQ, gap and
+// spacing in um, wow, flutter), tapes "typeI", "typeII" and "modern"
+// (bumpGain, thickness in um, drive). Anything left out keeps its built-in
+// value; a file with a newer version than this build reads is ignored.
+class TapeModelSet
+{
+public:
+    // Call from a non-realtime thread (constructors)
+    static std::shared_ptr<const TapeModelSet> acquire();
+
+    const TapeModel& get(MachineType machineType, TapeType tapeType, QualityMode quality) const
+    {
+        return models[static_cast<int>(machineType)][static_cast<int>(tapeType)][static_cast<int>(quality)];
+    }
+
+    // Bytes held once per process
+    size_t getMemoryBytes() const { return sizeof(*this); }
+
+    // Whether a profile file was applied
+    bool hasProfile() const { return profileApplied; }
+
+    static constexpr int PROFILE_VERSION = 1;
+
+private:
+    TapeModelSet();
+
+    bool applyProfile();
+
+    static constexpr int NUM_MACHINE_TYPES = TapeCharacteristics::NUM_MACHINE_TYPES;
+    static constexpr int NUM_TAPE_TYPES = TapeCharacteristics::NUM_TAPE_TYPES;
+    static constexpr int NUM_QUALITY_MODES = TapeCharacteristics::NUM_QUALITY_MODES;
+
+    TapeModel models[NUM_MACHINE_TYPES][NUM_TAPE_TYPES][NUM_QUALITY_MODES];
+    bool profileApplied = false;
+};
@@ -1,10 +1,141 @@
 #include "TapeProcessor.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+
+static_assert(2 + PlaybackLoss::NUM_SECTIONS <= TapeKernels::MAX_CASCADE_SECTIONS,
+              "De-emphasis, the head bump and the head losses run as one cascade");
+
+namespace
+{
+    constexpr size_t roundUpToCacheLine(size_t bytes)
+    {
+        return (bytes + 63) & ~static_cast<size_t>(63);
+    }
+
+    // Timeline random streams
+    enum TimelineStream : uint32_t { WowWalk = 0, FlutterWalk, Hiss };
+
+    // Random 64 bits for a seed, stream and index (splitmix64 finaliser)
+    uint64_t timelineHash(uint32_t seed, uint32_t stream, int64_t index)
+    {
+        uint64_t z = ((static_cast<uint64_t>(seed) << 32) | stream) + 0x9E3779B97F4A7C15ull * static_cast<uint64_t>(index + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Stand-in for the free-running random walk of the LFO offsets, which
+    // settles around 0.5: hashed values one cell apart, cosine-interpolated
+    float timelineWalk(uint32_t seed, uint32_t stream, double cells)
+    {
+        const double cell = std::floor(cells);
+        const auto index = static_cast<int64_t>(cell);
+        const float a = static_cast<float>(timelineHash(seed, stream, index) >> 40) * (1.0f / 16777216.0f);
+        const float b = static_cast<float>(timelineHash(seed, stream, index + 1) >> 40) * (1.0f / 16777216.0f);
+        const float t = 0.5f - 0.5f * std::cos(static_cast<float>(cells - cell) * juce::MathConstants<float>::pi);
+        return 0.45f + 0.1f * (a + (b - a) * t);
+    }
+
+    constexpr double TIMELINE_WALK_SECONDS = 2.0;   // About the random walk's time constant
+}
 
 TapeProcessor::TapeProcessor()
-    : rng(std::random_device{}()),
+    : models(TapeModelSet::acquire()),
+      rng(DSPUtils::makeSeed()),
       randomDist(-1.0f, 1.0f)
 {
+    // Arena and oversamplers are built on the first prepare(): sessions
+    // create many instances up front and some are never played
+    updateModel();
+}
+
+void TapeProcessor::allocateResources()
+{
+    allocateArena();
+
+    // Oversamplers for the Standard (2x) and HQ (4x) tiers; the half-band
+    // filters do not depend on the sample rate, so later prepares only reset them
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+    {
+        oversamplers2x[ch] = std::make_unique<juce::dsp::Oversampling<float>>(
+            1, 1, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+        oversamplers4x[ch] = std::make_unique<juce::dsp::Oversampling<float>>(
+            1, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+        oversamplers2x[ch]->initProcessing(static_cast<size_t>(MAX_BLOCK_SIZE));
+        oversamplers4x[ch]->initProcessing(static_cast<size_t>(MAX_BLOCK_SIZE));
+    }
+}
+
+void TapeProcessor::allocateArena()
+{
+    constexpr size_t stateBytes = roundUpToCacheLine(sizeof(ChannelState) * MAX_CHANNELS)
+                                + roundUpToCacheLine(sizeof(ControlState))
+                                + roundUpToCacheLine(sizeof(SegmentControl) * MAX_SEGMENTS);
+    constexpr size_t channelBytes = roundUpToCacheLine(sizeof(float) * MAX_DELAY_SAMPLES)
+                                  + 2 * roundUpToCacheLine(sizeof(float) * DRY_DELAY_SIZE)
+                                  + roundUpToCacheLine(sizeof(float) * MAX_BLOCK_SIZE);
+    constexpr size_t scratchBytes = 4 * roundUpToCacheLine(sizeof(float) * MAX_BLOCK_SIZE)
+                                  + roundUpToCacheLine(sizeof(float) * OVERSAMPLER_HISTORY)
+                                  + roundUpToCacheLine(sizeof(TransferScope::Point) * MAX_BLOCK_SIZE);
+
+    // One zeroed allocation for everything, with slack to align the base
+    arenaSize = stateBytes + channelBytes * MAX_CHANNELS + scratchBytes + CACHE_LINE_SIZE;
+    arena.allocate(arenaSize, true);
+
+    auto address = reinterpret_cast<uintptr_t>(arena.get());
+    char* cursor = arena.get() + (roundUpToCacheLine(address) - address);
+
+    auto carve = [&cursor](size_t bytes)
+    {
+        char* block = cursor;
+        cursor += roundUpToCacheLine(bytes);
+        return block;
+    };
+
+    channelState = reinterpret_cast<ChannelState*>(carve(sizeof(ChannelState) * MAX_CHANNELS));
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        new (channelState + ch) ChannelState();
+    control = new (carve(sizeof(ControlState))) ControlState();
+    segments = reinterpret_cast<SegmentControl*>(carve(sizeof(SegmentControl) * MAX_SEGMENTS));
+    for (int s = 0; s < MAX_SEGMENTS; ++s)
+        new (segments + s) SegmentControl();
+
+    for (auto& buffers : channelBuffers)
+    {
+        buffers.delayLine = reinterpret_cast<float*>(carve(sizeof(float) * MAX_DELAY_SAMPLES));
+        buffers.dryDelay = reinterpret_cast<float*>(carve(sizeof(float) * DRY_DELAY_SIZE));
+        buffers.pathDelay = reinterpret_cast<float*>(carve(sizeof(float) * DRY_DELAY_SIZE));
+        buffers.dry = reinterpret_cast<float*>(carve(sizeof(float) * MAX_BLOCK_SIZE));
+    }
+
+    delayTimes = reinterpret_cast<float*>(carve(sizeof(float) * MAX_BLOCK_SIZE));
+    hissLeft = reinterpret_cast<float*>(carve(sizeof(float) * MAX_BLOCK_SIZE));
+    hissRight = reinterpret_cast<float*>(carve(sizeof(float) * MAX_BLOCK_SIZE));
+    responseDry = reinterpret_cast<float*>(carve(sizeof(float) * MAX_BLOCK_SIZE));
+    oversamplerHistory = reinterpret_cast<float*>(carve(sizeof(float) * OVERSAMPLER_HISTORY));
+    scopePoints = reinterpret_cast<TransferScope::Point*>(carve(sizeof(TransferScope::Point) * MAX_BLOCK_SIZE));
+}
+
+TapeProcessor::MemoryFootprint TapeProcessor::getMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+
+    // Object, arena and the oversamplers' upsampled buffers (their filter
+    // state is small in comparison and not exposed by JUCE)
+    footprint.perInstance = sizeof(*this) + arenaSize;
+
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        for (auto* oversampler : { oversamplers2x[ch].get(), oversamplers4x[ch].get() })
+            if (oversampler != nullptr)
+                footprint.perInstance += oversampler->getOversamplingFactor() * static_cast<size_t>(MAX_BLOCK_SIZE) * sizeof(float);
+
+    footprint.perInstance += convolver.getMemoryBytes();
+
+    footprint.shared = models->getMemoryBytes();
+    if (responses != nullptr)
+        footprint.shared += responses->getMemoryBytes();
+    return footprint;
 }
 
 void TapeProcessor::prepare(double sampleRate, int samplesPerBlock)
@@ -12,50 +143,81 @@ void TapeProcessor::prepare(double sampleRate, int samplesPerBlock)
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
-    // Initialize delay lines
-    int delaySize = static_cast<int>(sampleRate * 0.05);  // 50ms max
-    delayLineL.resize(delaySize, 0.0f);
-    delayLineR.resize(delaySize, 0.0f);
-    writeIndex = 0;
+    if (! isAllocated())
+        allocateResources();
+
+    quality = pendingQuality;
+    antialiasing = pendingAntialiasing;
+    updateModel();
+
+    // Pick the widest kernel variant the CPU supports
+    kernels = &TapeKernels::selectKernels();
+
+    // Machine responses for this rate, built by the first instance to ask
+    responses = MachineResponseSet::acquire(sampleRate);
+    convolver.prepare(*responses, MAX_CHANNELS);
+    updateMachineResponse();
+
+    // Delay line covers 50ms, capped at the preallocated length
+    delaySize = std::min(static_cast<int>(sampleRate * 0.05), MAX_DELAY_SAMPLES);
+
+    // Control-rate smoothing: ~10ms time constant, advanced once per tick
+    controlSmoothing = 1.0f - std::exp(-static_cast<float>(CONTROL_BLOCK_SIZE) / static_cast<float>(sampleRate * 0.01));
+    bypassFadeStep = static_cast<float>(1.0 / (BYPASS_FADE_SECONDS * sampleRate));
 
     // Update all filter coefficients
     updateHeadBumpFilter();
-    updateHFRolloffFilter();
+    updatePlaybackLossFilter();
+    updateEmphasisFilter();
     updateWowFlutterLFO();
+    updateQualitySettings();
 
     reset();
 }
 
 void TapeProcessor::reset()
 {
-    // Reset saturation state
-    hysteresisStateL = 0.0f;
-    hysteresisStateR = 0.0f;
-
-    // Reset head bump filters
-    headBumpStateL = {};
-    headBumpStateR = {};
+    if (! isAllocated())
+        return;
 
-    // Reset HF rolloff filters
-    hfRolloffStateL = 0.0f;
-    hfRolloffStateR = 0.0f;
+    // Reset the dry delay, LFO phases and the timeline
+    for (auto& buffers : channelBuffers)
+        std::fill(buffers.dryDelay, buffers.dryDelay + DRY_DELAY_SIZE, 0.0f);
+    *control = {};
+    control->bypassFade = bypassed ? 1.0f : 0.0f;
 
-    // Reset warmth filters
-    warmthStateL = {};
-    warmthStateR = {};
+    resetChain();
+}
 
-    // Reset delay lines
-    std::fill(delayLineL.begin(), delayLineL.end(), 0.0f);
-    std::fill(delayLineR.begin(), delayLineR.end(), 0.0f);
-    writeIndex = 0;
+void TapeProcessor::resetChain()
+{
+    // Reset saturation, filter and emphasis state
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        channelState[ch] = {};
 
-    // Reset LFO phases
-    wowPhase = 0.0f;
-    flutterPhase = 0.0f;
+    for (auto& buffers : channelBuffers)
+    {
+        std::fill(buffers.delayLine, buffers.delayLine + delaySize, 0.0f);
+        std::fill(buffers.pathDelay, buffers.pathDelay + DRY_DELAY_SIZE, 0.0f);
+    }
 
-    // Reset hiss filter
-    hissFilterStateL = 0.0f;
-    hissFilterStateR = 0.0f;
+    // Start from the current targets rather than ramping from defaults
+    control->inputGain = inputGainLinear;
+    control->outputGain = outputGainLinear;
+    control->mix = mixAmount;
+    control->responseMix = headBumpAmount;
+    control->headBump = headBumpCoeffs;
+    std::copy(std::begin(playbackLossCoeffs), std::end(playbackLossCoeffs), std::begin(control->playbackLoss));
+    control->delayEnd = baseDelayMs * static_cast<float>(currentSampleRate) / 1000.0f;
+
+    // Reset oversampling filters and the convolution history
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+    {
+        oversamplers2x[ch]->reset();
+        oversamplers4x[ch]->reset();
+    }
+    std::fill(oversamplerHistory, oversamplerHistory + OVERSAMPLER_HISTORY, 0.0f);
+    convolver.reset();
 }
 
 void TapeProcessor::setInputDrive(float dB)
@@ -66,40 +228,65 @@ void TapeProcessor::setInputDrive(float dB)
 
 void TapeProcessor::setSaturation(float amount)
 {
-    saturation = std::clamp(amount, 0.0f, 100.0f);
+    float newValue = std::clamp(amount, 0.0f, 100.0f);
+    if (juce::exactlyEqual(newValue, saturation))
+        return;  // Coefficients only need recomputing on change
+
+    saturation = newValue;
     saturationAmount = saturation / 100.0f;
+    updateQualitySettings();
 }
 
 void TapeProcessor::setWarmth(float amount)
 {
-    warmth = std::clamp(amount, 0.0f, 100.0f);
+    float newValue = std::clamp(amount, 0.0f, 100.0f);
+    if (juce::exactlyEqual(newValue, warmth))
+        return;  // Coefficients only need recomputing on change
+
+    warmth = newValue;
     warmthAmount = warmth / 100.0f;
-    updateHFRolloffFilter();
+    updatePlaybackLossFilter();
 }
 
 void TapeProcessor::setHeadBump(float amount)
 {
-    headBump = std::clamp(amount, 0.0f, 100.0f);
+    float newValue = std::clamp(amount, 0.0f, 100.0f);
+    if (juce::exactlyEqual(newValue, headBump))
+        return;  // Coefficients only need recomputing on change
+
+    headBump = newValue;
     headBumpAmount = headBump / 100.0f;
     updateHeadBumpFilter();
 }
 
 void TapeProcessor::setBumpFreq(float freq)
 {
-    bumpFreq = std::clamp(freq, 40.0f, 150.0f);
+    float newValue = std::clamp(freq, 40.0f, 150.0f);
+    if (juce::exactlyEqual(newValue, bumpFreq))
+        return;  // Coefficients only need recomputing on change
+
+    bumpFreq = newValue;
     updateHeadBumpFilter();
 }
 
 void TapeProcessor::setWow(float amount)
 {
-    wow = std::clamp(amount, 0.0f, 100.0f);
+    float newValue = std::clamp(amount, 0.0f, 100.0f);
+    if (juce::exactlyEqual(newValue, wow))
+        return;  // Coefficients only need recomputing on change
+
+    wow = newValue;
     wowDepth = (wow / 100.0f) * 3.0f;  // Max 3ms pitch deviation
     updateWowFlutterLFO();
 }
 
 void TapeProcessor::setFlutter(float amount)
 {
-    flutter = std::clamp(amount, 0.0f, 100.0f);
+    float newValue = std::clamp(amount, 0.0f, 100.0f);
+    if (juce::exactlyEqual(newValue, flutter))
+        return;  // Coefficients only need recomputing on change
+
+    flutter = newValue;
     flutterDepth = (flutter / 100.0f) * 0.5f;  // Max 0.5ms pitch deviation
     updateWowFlutterLFO();
 }
@@ -126,9 +313,13 @@ void TapeProcessor::setMix(float amount)
 
 void TapeProcessor::setAge(float amount)
 {
-    age = std::clamp(amount, 0.0f, 100.0f);
+    float newValue = std::clamp(amount, 0.0f, 100.0f);
+    if (juce::exactlyEqual(newValue, age))
+        return;  // Coefficients only need recomputing on change
+
+    age = newValue;
     ageAmount = age / 100.0f;
-    updateHFRolloffFilter();
+    updatePlaybackLossFilter();
     updateWowFlutterLFO();
 }
 
@@ -140,47 +331,219 @@ void TapeProcessor::setBias(float amount)
 
 void TapeProcessor::setMachineType(int type)
 {
-    machineType = static_cast<MachineType>(std::clamp(type, 0, 2));
+    auto newType = static_cast<MachineType>(std::clamp(type, 0, 2));
+    if (newType == machineType)
+        return;
+
+    machineType = newType;
+    updateModel();
+    updateMachineResponse();
     updateHeadBumpFilter();
-    updateHFRolloffFilter();
+    updatePlaybackLossFilter();
+    updateEmphasisFilter();
+    updateWowFlutterLFO();
 }
 
 void TapeProcessor::setTapeType(int type)
 {
-    tapeType = static_cast<TapeType>(std::clamp(type, 0, 2));
+    auto newType = static_cast<TapeType>(std::clamp(type, 0, 2));
+    if (newType == tapeType)
+        return;
+
+    tapeType = newType;
+    updateModel();
     updateHeadBumpFilter();
-    updateHFRolloffFilter();
+    updatePlaybackLossFilter();
+    updateQualitySettings();    // ADAA only replaces oversampling for the memoryless curves
 }
 
-void TapeProcessor::updateHeadBumpFilter()
+void TapeProcessor::setQuality(int mode)
 {
-    // Head bump frequency varies with tape speed
-    float speedMultiplier = 1.0f;
-    switch (machineType)
+    pendingQuality = static_cast<QualityMode>(std::clamp(mode, 0, 2));
+}
+
+void TapeProcessor::setAntialiasing(int mode)
+{
+    pendingAntialiasing = static_cast<AntialiasingMode>(std::clamp(mode, 0, 2));
+}
+
+void TapeProcessor::setResponseMode(int mode)
+{
+    auto newMode = static_cast<ResponseMode>(std::clamp(mode, 0, 1));
+    if (newMode == responseMode)
+        return;
+
+    responseMode = newMode;
+
+    // Start the convolution from silence rather than stale history
+    if (isAllocated())
+        convolver.reset();
+}
+
+void TapeProcessor::setEmphasis(int mode)
+{
+    auto newMode = static_cast<EmphasisMode>(std::clamp(mode, 0, 2));
+    if (newMode == emphasis)
+        return;
+
+    emphasis = newMode;
+    updateEmphasisFilter();
+
+    // The pair starts from silence, so nothing recorded with the old curve
+    // is played back through the new one
+    if (isAllocated())
+        for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+            channelState[ch].recordEmphasis = channelState[ch].playbackEmphasis = {};
+}
+
+void TapeProcessor::setTimeline(uint32_t seed)
+{
+    timeline = true;
+    timelineSeed = seed;
+    updateWowFlutterLFO();
+}
+
+void TapeProcessor::seekTimeline(int64_t samplePosition)
+{
+    static_assert(TIMELINE_ALIGNMENT % CONTROL_BLOCK_SIZE == 0,
+                  "Control ticks must fall on the same positions after a seek");
+    jassert(isAllocated() && timeline && samplePosition % TIMELINE_ALIGNMENT == 0);
+
+    control->position = samplePosition;
+    control->samplesUntilTick = 0;
+
+    // The wow/flutter read position is the write head minus the delay, in
+    // float, so its rounding depends on where the head is: put it where a
+    // render from position 0 would have it
+    control->writeIndex = static_cast<int>(samplePosition % delaySize);
+}
+
+void TapeProcessor::setBypassed(bool shouldBypass)
+{
+    bypassed = shouldBypass;
+}
+
+uint32_t TapeProcessor::getActiveStages() const
+{
+    uint32_t stages = 0;
+
+    if (activeOversamplers[0] != nullptr)
+        stages |= OversamplingStage;
+    if (antiderivativeActive)
+        stages |= AntiderivativeStage;
+    if (responseMode == ResponseMode::Convolution && ! convolutionIdle)
+        stages |= ConvolutionStage;
+    if (headBumpAmount > 0.0f)
+        stages |= HeadBumpStage;
+    if (wowDepth > 0.0f || flutterDepth > 0.0f)
+        stages |= WowFlutterStage;
+    if (hissLevel > 0.0f)
+        stages |= HissStage;
+    if (bypassActive)
+        return BypassedStage;
+
+    if (dualMonoActive)
+        stages |= DualMonoStage;
+
+    return stages;
+}
+
+void TapeProcessor::updateModel()
+{
+    model = &models->get(machineType, tapeType, quality);
+}
+
+void TapeProcessor::updateMachineResponse()
+{
+    if (responses != nullptr)
+        machineResponse = &responses->get(machineType);
+}
+
+void TapeProcessor::updateQualitySettings()
+{
+    auto* previousOversampler = activeOversamplers[0];
+    const bool wasAntiderivative = antiderivativeActive;
+
+    // ADAA replaces oversampling for the memoryless curves; Type I's
+    // hysteresis has memory, so it keeps the tier's oversampling
+    antiderivativeActive = (antialiasing != AntialiasingMode::Oversampling && tapeType != TapeType::TypeI);
+
+    const auto tierOversampler = [this](int ch) -> juce::dsp::Oversampling<float>*
     {
-        case MachineType::IPS_7_5:  speedMultiplier = 0.7f; break;   // Lower bump
-        case MachineType::IPS_15:   speedMultiplier = 1.0f; break;   // Reference
-        case MachineType::IPS_30:   speedMultiplier = 1.5f; break;   // Higher bump
-    }
+        switch (model->oversamplingFactor)
+        {
+            case 2:   return oversamplers2x[ch].get();
+            case 4:   return oversamplers4x[ch].get();
+            default:  return nullptr;
+        }
+    };
 
-    float centerFreq = bumpFreq * speedMultiplier;
-    centerFreq = std::clamp(centerFreq, 30.0f, 200.0f);
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        activeOversamplers[ch] = antiderivativeActive ? nullptr : tierOversampler(ch);
 
-    // Gain amount varies with tape type
-    float typeGain = 1.0f;
-    switch (tapeType)
+    hysteresisSteps = model->hysteresisSteps;
+
+    const auto* oversampler = activeOversamplers[0];
+    oversamplingFactor = (oversampler != nullptr) ? static_cast<int>(oversampler->getOversamplingFactor()) : 1;
+
+    // The reported latency is the slowest path's among those the tape type
+    // can switch between: the tier's oversampling, or second-order ADAA's
+    // one sample. It only depends on the quality and anti-aliasing, so it
+    // changes at prepare() only. First-order ADAA delays by half a sample,
+    // which is left uncompensated
+    const auto* tier = tierOversampler(0);
+    const int oversamplingLatency = (tier != nullptr) ? static_cast<int>(tier->getLatencyInSamples()) : 0;
+    const int antiderivativeLatency = (antialiasing == AntialiasingMode::ADAA2) ? 1 : 0;
+
+    latencySamples = (antialiasing == AntialiasingMode::Oversampling) ? oversamplingLatency
+                                                                      : std::max(oversamplingLatency, antiderivativeLatency);
+
+    jassert(latencySamples < DRY_DELAY_SIZE);
+    latencySamples = std::min(latencySamples, DRY_DELAY_SIZE - 1);
+
+    // The active path is padded up to it
+    pathPadding = std::max(0, latencySamples - (antiderivativeActive ? antiderivativeLatency : oversamplingLatency));
+
+    // Start a newly selected saturation path from silence
+    if (isAllocated() && (oversampler != previousOversampler || antiderivativeActive != wasAntiderivative))
     {
-        case TapeType::TypeI:   typeGain = 1.2f; break;   // More pronounced
-        case TapeType::TypeII:  typeGain = 0.9f; break;   // Subtler
-        case TapeType::Modern:  typeGain = 0.7f; break;   // Minimal
+        for (auto* channelOversampler : activeOversamplers)
+            if (channelOversampler != nullptr)
+                channelOversampler->reset();
+        std::fill(oversamplerHistory, oversamplerHistory + OVERSAMPLER_HISTORY, 0.0f);
+        for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+            channelState[ch].antiderivative = {};
+        for (auto& buffers : channelBuffers)
+            std::fill(buffers.pathDelay, buffers.pathDelay + DRY_DELAY_SIZE, 0.0f);
     }
 
-    // Calculate peak filter coefficients (bell/parametric EQ)
-    float gainDb = headBumpAmount * 6.0f * typeGain;  // Max +6dB boost
-    float Q = 1.5f;  // Moderate Q for smooth bump
+    // ~6000 transfer curve pairs per second whatever the rate
+    scopeStride = std::max(1, static_cast<int>(std::lround(currentSampleRate * oversamplingFactor / 6000.0)));
+
+    // Keep the magnetic lag time constant independent of the oversampling factor
+    float lagCoeff = 0.3f + saturationAmount * 0.4f;
+    hysteresisLag = 1.0f - std::pow(1.0f - lagCoeff, 1.0f / static_cast<float>(oversamplingFactor));
+}
+
+void TapeProcessor::updateHeadBumpFilter()
+{
+    headBumpCoeffs = calculateHeadBumpCoefficients(*model, bumpFreq, headBumpAmount, currentSampleRate);
+}
+
+TapeKernels::BiquadCoefficients TapeProcessor::calculateHeadBumpCoefficients(const TapeModel& tapeModel, float frequency,
+                                                                            float amount, double sampleRate)
+{
+    // Head bump frequency varies with tape speed
+    float centerFreq = frequency * tapeModel.bumpSpeedMultiplier;
+    centerFreq = std::clamp(centerFreq, 30.0f, 200.0f);
+
+    // Calculate peak filter coefficients (bell/parametric EQ); the boost
+    // at full amount varies with tape type
+    float gainDb = amount * tapeModel.bumpMaxGainDb;
+    float Q = tapeModel.bumpQ;  // Moderate Q for smooth bump
 
     float A = std::pow(10.0f, gainDb / 40.0f);
-    float omega = 2.0f * juce::MathConstants<float>::pi * centerFreq / static_cast<float>(currentSampleRate);
+    float omega = 2.0f * juce::MathConstants<float>::pi * centerFreq / static_cast<float>(sampleRate);
     float sinOmega = std::sin(omega);
     float cosOmega = std::cos(omega);
     float alpha = sinOmega / (2.0f * Q);
@@ -193,56 +556,115 @@ void TapeProcessor::updateHeadBumpFilter()
     float a2 = 1.0f - alpha / A;
 
     // Normalize coefficients
-    headBumpB0 = b0 / a0;
-    headBumpB1 = b1 / a0;
-    headBumpB2 = b2 / a0;
-    headBumpA1 = a1 / a0;
-    headBumpA2 = a2 / a0;
+    TapeKernels::BiquadCoefficients coeffs;
+    coeffs.b0 = b0 / a0;
+    coeffs.b1 = b1 / a0;
+    coeffs.b2 = b2 / a0;
+    coeffs.a1 = a1 / a0;
+    coeffs.a2 = a2 / a0;
+    return coeffs;
+}
+
+void TapeProcessor::updatePlaybackLossFilter()
+{
+    calculatePlaybackLoss(*model, warmthAmount, ageAmount, currentSampleRate, playbackLossCoeffs);
 }
 
-void TapeProcessor::updateHFRolloffFilter()
+void TapeProcessor::calculatePlaybackLoss(const TapeModel& tapeModel, float warmthLevel, float ageLevel,
+                                          double sampleRate,
+                                          TapeKernels::BiquadCoefficients (&sections)[PlaybackLoss::NUM_SECTIONS])
 {
-    // HF cutoff varies with tape speed and type
-    float baseCutoff = 15000.0f;
+    // Warmth records deeper into the coating and age holds the tape further
+    // from a worn head; both lose more at short wavelengths
+    PlaybackLoss::Geometry geometry;
+    geometry.speed = tapeModel.tapeSpeed;
+    geometry.gap = tapeModel.gapWidth;
+    geometry.spacing = tapeModel.headSpacing + ageLevel * AGE_SPACING;
+    geometry.thickness = tapeModel.coatingThickness + warmthLevel * WARMTH_DEPTH;
+
+    PlaybackLoss::design(geometry, sampleRate, sections);
+}
 
-    switch (machineType)
-    {
-        case MachineType::IPS_7_5:  baseCutoff = 10000.0f; break;  // Darker
-        case MachineType::IPS_15:   baseCutoff = 15000.0f; break;  // Reference
-        case MachineType::IPS_30:   baseCutoff = 18000.0f; break;  // Brighter
-    }
+void TapeProcessor::updateEmphasisFilter()
+{
+    calculateEmphasis(emphasis, machineType, currentSampleRate, recordEmphasis, playbackEmphasis);
+}
 
-    switch (tapeType)
+void TapeProcessor::calculateEmphasis(EmphasisMode mode, MachineType machineType, double sampleRate,
+                                      TapeKernels::BiquadCoefficients& record, TapeKernels::BiquadCoefficients& playback)
+{
+    if (mode == EmphasisMode::Off)
     {
-        case TapeType::TypeI:   baseCutoff *= 0.85f; break;  // Warmer
-        case TapeType::TypeII:  baseCutoff *= 1.0f;  break;  // Reference
-        case TapeType::Modern:  baseCutoff *= 1.1f;  break;  // Extended
+        record = playback = {};
+        return;
     }
 
-    // Warmth and age reduce HF
-    float warmthCut = 1.0f - (warmthAmount * 0.4f);  // Up to 40% reduction
-    float ageCut = 1.0f - (ageAmount * 0.3f);        // Up to 30% reduction
+    const auto& standard = TapeCharacteristics::getEmphasis(mode, machineType);
 
-    float finalCutoff = baseCutoff * warmthCut * ageCut;
-    finalCutoff = std::clamp(finalCutoff, 2000.0f, 20000.0f);
+    // First-order shelf (1 + s/zero) / (1 + s/pole) by the bilinear
+    // transform, rising by ratio. The zero is prewarped and kept below
+    // Nyquist; the pole is placed relative to it after warping, so the
+    // shelf reaches exactly ratio at Nyquist rather than overshooting it
+    const auto shelf = [sampleRate](double zeroHz, double ratio, double (&numerator)[2], double (&denominator)[2])
+    {
+        const double zero = 1.0 / std::tan(juce::MathConstants<double>::pi * std::min(zeroHz, 0.45 * sampleRate) / sampleRate);
+        const double pole = zero / ratio;
+
+        numerator[0] = 1.0 + zero;
+        numerator[1] = 1.0 - zero;
+        denominator[0] = 1.0 + pole;
+        denominator[1] = 1.0 - pole;
+    };
+
+    // Treble boost from the high time constant, limited to EMPHASIS_HIGH_SHELF
+    const double highHz = 1.0e6 / (2.0 * juce::MathConstants<double>::pi * standard.highTimeConstant);
+    double highNumerator[2], highDenominator[2];
+    shelf(highHz, EMPHASIS_HIGH_SHELF, highNumerator, highDenominator);
+
+    // Bass cut below the low time constant (NAB), the inverse of playback's
+    // bass boost, limited to EMPHASIS_LOW_SHELF
+    double lowNumerator[2] = { 1.0, 0.0 }, lowDenominator[2] = { 1.0, 0.0 };
+    double lowGain = 1.0;
+    if (standard.lowTimeConstant > 0.0f)
+    {
+        const double lowHz = 1.0e6 / (2.0 * juce::MathConstants<double>::pi * standard.lowTimeConstant);
+        shelf(lowHz / EMPHASIS_LOW_SHELF, EMPHASIS_LOW_SHELF, lowNumerator, lowDenominator);
+        lowGain = 1.0 / EMPHASIS_LOW_SHELF;
+    }
 
-    // One-pole lowpass coefficient
-    float omega = 2.0f * juce::MathConstants<float>::pi * finalCutoff / static_cast<float>(currentSampleRate);
-    hfRolloffCoeffL = omega / (1.0f + omega);
-    hfRolloffCoeffR = hfRolloffCoeffL;
+    // Product of the two shelves
+    const double a0 = highDenominator[0] * lowDenominator[0];
+
+    record.b0 = static_cast<float>(lowGain * highNumerator[0] * lowNumerator[0] / a0);
+    record.b1 = static_cast<float>(lowGain * (highNumerator[0] * lowNumerator[1] + highNumerator[1] * lowNumerator[0]) / a0);
+    record.b2 = static_cast<float>(lowGain * highNumerator[1] * lowNumerator[1] / a0);
+    record.a1 = static_cast<float>((highDenominator[0] * lowDenominator[1] + highDenominator[1] * lowDenominator[0]) / a0);
+    record.a2 = static_cast<float>(highDenominator[1] * lowDenominator[1] / a0);
+
+    // Playback swaps its poles and zeros
+    const float scale = 1.0f / record.b0;
+    playback.b0 = scale;
+    playback.b1 = record.a1 * scale;
+    playback.b2 = record.a2 * scale;
+    playback.a1 = record.b1 * scale;
+    playback.a2 = record.b2 * scale;
 }
 
 void TapeProcessor::updateWowFlutterLFO()
 {
+    // On the timeline the rates and offsets depend on the seed alone
+    if (timeline)
+        rng.seed(timelineSeed);
+
     // Wow rate: 0.5-3 Hz (slow pitch variation)
     // Age increases wow
     float ageWowBoost = 1.0f + ageAmount * 0.5f;
-    wowRate = 0.5f + randomDist(rng) * 0.5f;  // Slight randomness
+    wowRate = model->wowRate + randomDist(rng) * model->wowRateSpread;  // Slight randomness
     wowPhaseIncrement = wowRate / static_cast<float>(currentSampleRate);
 
     // Flutter rate: 5-30 Hz (fast pitch variation)
     float ageFlutterBoost = 1.0f + ageAmount * 0.3f;
-    flutterRate = 10.0f + randomDist(rng) * 5.0f;  // Slight randomness
+    flutterRate = model->flutterRate + randomDist(rng) * model->flutterRateSpread;  // Slight randomness
     flutterPhaseIncrement = flutterRate / static_cast<float>(currentSampleRate);
 
     // Random offsets for natural feel
@@ -250,229 +672,725 @@ void TapeProcessor::updateWowFlutterLFO()
     flutterRandomOffset = randomDist(rng) * 0.1f;
 }
 
-void TapeProcessor::writeToDelayLine(float sample, int channel)
+void TapeProcessor::updateControlRate()
 {
-    if (channel == 0)
-        delayLineL[writeIndex] = sample;
+    // Interpolate gains and filter coefficients toward their targets
+    auto smooth = [this](float& current, float target) { current += controlSmoothing * (target - current); };
+    auto smoothCoefficients = [&smooth](TapeKernels::BiquadCoefficients& current,
+                                        const TapeKernels::BiquadCoefficients& target)
+    {
+        smooth(current.b0, target.b0);
+        smooth(current.b1, target.b1);
+        smooth(current.b2, target.b2);
+        smooth(current.a1, target.a1);
+        smooth(current.a2, target.a2);
+    };
+
+    smooth(control->inputGain, inputGainLinear);
+    smooth(control->outputGain, outputGainLinear);
+    smooth(control->mix, mixAmount);
+    smooth(control->responseMix, headBumpAmount);
+
+    // Settle at no head bump (below -80 dB), so the convolution can stop
+    if (headBumpAmount <= 0.0f && control->responseMix < 1.0e-4f)
+        control->responseMix = 0.0f;
+    smoothCoefficients(control->headBump, headBumpCoeffs);
+
+    // Both loss sections have real poles, so the interpolated ones stay stable
+    for (int s = 0; s < PlaybackLoss::NUM_SECTIONS; ++s)
+        smoothCoefficients(control->playbackLoss[s], playbackLossCoeffs[s]);
+
+    if (timeline)
+    {
+        // Phases and offsets at the absolute position this tick ends at
+        const double end = static_cast<double>(control->position + CONTROL_BLOCK_SIZE);
+        control->wowPhase = static_cast<float>(std::fmod(end * wowRate / currentSampleRate, 1.0));
+        control->flutterPhase = static_cast<float>(std::fmod(end * flutterRate / currentSampleRate, 1.0));
+
+        const double cells = end / (currentSampleRate * TIMELINE_WALK_SECONDS);
+        wowRandomOffset = timelineWalk(timelineSeed, WowWalk, cells);
+        flutterRandomOffset = timelineWalk(timelineSeed, FlutterWalk, cells);
+    }
     else
-        delayLineR[writeIndex] = sample;
+    {
+        // Advance LFOs by one control block
+        control->wowPhase += wowPhaseIncrement * CONTROL_BLOCK_SIZE;
+        control->wowPhase -= std::floor(control->wowPhase);
+
+        control->flutterPhase += flutterPhaseIncrement * CONTROL_BLOCK_SIZE;
+        control->flutterPhase -= std::floor(control->flutterPhase);
+
+        // Occasionally update random offsets for natural variation (~1000 samples)
+        if (++control->randomWalkTicks >= RANDOM_WALK_TICKS)
+        {
+            control->randomWalkTicks = 0;
+            wowRandomOffset = wowRandomOffset * 0.99f + randomDist(rng) * 0.01f;
+            flutterRandomOffset = flutterRandomOffset * 0.99f + randomDist(rng) * 0.01f;
+        }
+    }
+
+    // Calculate wow modulation (slow sine with randomness)
+    float wowMod = std::sin(control->wowPhase * 2.0f * juce::MathConstants<float>::pi);
+    wowMod += wowRandomOffset * std::sin(control->wowPhase * 1.7f * juce::MathConstants<float>::pi);  // Irregular
+    wowMod *= wowDepth * model->wowDepthScale;
+
+    // Calculate flutter modulation (fast with randomness)
+    float flutterMod = std::sin(control->flutterPhase * 2.0f * juce::MathConstants<float>::pi);
+    flutterMod += flutterRandomOffset * std::sin(control->flutterPhase * 2.3f * juce::MathConstants<float>::pi);
+    flutterMod *= flutterDepth * model->flutterDepthScale;
+
+    // Age increases the effect
+    float ageBoost = 1.0f + ageAmount * 0.5f;
+    float totalModulation = (wowMod + flutterMod) * ageBoost;
+
+    // Convert modulation to delay time (base delay + modulation), reached at the end of this tick
+    float delaySamples = (baseDelayMs + totalModulation) * static_cast<float>(currentSampleRate) / 1000.0f;
+    control->delayStart = control->delayEnd;
+    control->delayEnd = std::clamp(delaySamples, 2.0f, static_cast<float>(delaySize - 2));
+}
+
+void TapeProcessor::computeWowFlutterDelays(int start, int numSamples)
+{
+    // Linear ramp between the delays computed at the surrounding control ticks
+    const int position = CONTROL_BLOCK_SIZE - control->samplesUntilTick;
+    const float step = (control->delayEnd - control->delayStart) / static_cast<float>(CONTROL_BLOCK_SIZE);
+
+    for (int i = 0; i < numSamples; ++i)
+        delayTimes[start + i] = control->delayStart + step * static_cast<float>(position + i + 1);
+}
+
+void TapeProcessor::generateHiss(int start, int numSamples)
+{
+    float* noiseL = hissLeft + start;
+    float* noiseR = hissRight + start;
+
+    // On the timeline the noise restarts from a seed for each control tick's
+    // position, so it does not depend on how the blocks are split
+    if (timeline && control->samplesUntilTick == CONTROL_BLOCK_SIZE)
+        noiseGen.setSeed(static_cast<uint32_t>(timelineHash(timelineSeed, Hiss, control->position)));
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        noiseL[i] = noiseGen.nextSample();
+        noiseR[i] = noiseGen.nextSample();
+    }
 }
 
-float TapeProcessor::readFromDelayLine(float delaySamples, int channel)
+float TapeProcessor::processHysteresis(float input, int channel)
 {
-    const auto& delayLine = (channel == 0) ? delayLineL : delayLineR;
-    int size = static_cast<int>(delayLine.size());
+    float& hysteresisState = channelState[channel].hysteresis;
+
+    // Ferric: warmer, more saturation, even harmonics
+    float saturated = model->fastTanh
+        ? DSPUtils::hysteresis<true>(input, hysteresisState, saturationAmount, hysteresisLag, hysteresisSteps)
+        : DSPUtils::hysteresis<false>(input, hysteresisState, saturationAmount, hysteresisLag, hysteresisSteps);
 
-    // Fractional delay with linear interpolation
-    float readPos = static_cast<float>(writeIndex) - delaySamples;
-    while (readPos < 0.0f)
-        readPos += static_cast<float>(size);
+    return saturated * model->compensation;  // Compensate for drive
+}
 
-    int index0 = static_cast<int>(readPos) % size;
-    int index1 = (index0 + 1) % size;
-    float frac = readPos - std::floor(readPos);
+void TapeProcessor::processAntiderivativeSaturation(float* data, int numSamples, float offset, float drive, int channel)
+{
+    auto& state = channelState[channel].antiderivative;
+
+    auto run = [&](const auto& curve)
+    {
+        if (antialiasing == AntialiasingMode::ADAA2)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = DSPUtils::adaa2(curve, (data[i] + offset) * drive, state);
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = DSPUtils::adaa1(curve, (data[i] + offset) * drive, state);
+        }
+    };
 
-    return delayLine[index0] * (1.0f - frac) + delayLine[index1] * frac;
+    // Exact curves whatever the tier: the antiderivatives are closed form
+    if (tapeType == TapeType::Modern)
+        run(DSPUtils::SoftKneeCurve());
+    else
+        run(DSPUtils::TanhCurve());
 }
 
-float TapeProcessor::processSaturation(float input, int channel)
+void TapeProcessor::processSaturation(float* data, int numSamples, int channel)
 {
-    float& hysteresisState = (channel == 0) ? hysteresisStateL : hysteresisStateR;
+    if (saturationAmount <= 0.0f)
+        return;
 
     // Bias affects the saturation curve
-    float biasOffset = (biasAmount - 0.5f) * 0.1f;  // -0.05 to +0.05
-    float biasedInput = input + biasOffset;
+    const float biasOffset = (biasAmount - 0.5f) * 0.1f;  // -0.05 to +0.05
 
     // Different saturation characteristics per tape type
-    float drive = 1.0f + saturationAmount * 4.0f;  // 1 to 5x drive
+    const float drive = (1.0f + saturationAmount * 4.0f) * model->driveScale;  // 1 to 5x drive
+
+    // Eco tier trades tanh accuracy for speed
+    const bool useFastTanh = model->fastTanh;
+
+    // Transfer curve display (only while it is open): sample positions on
+    // channel 0, spaced scopeStride apart across chunks. The pairs go to
+    // arena scratch, so a closed display costs nothing here
+    constexpr int maxScopePoints = MAX_BLOCK_SIZE;
+    int numScopePoints = 0;
+    const int firstScopeSample = scopePhase;
+
+    if (channel == 0)
+    {
+        if (transferScope.isActive())
+            for (int i = firstScopeSample; i < numSamples && numScopePoints < maxScopePoints; i += scopeStride)
+                scopePoints[numScopePoints++].input = data[i];
+
+        // Offset of the next pair into the following chunk
+        scopePhase = (firstScopeSample >= numSamples) ? firstScopeSample - numSamples
+                                                      : (scopeStride - (numSamples - firstScopeSample) % scopeStride) % scopeStride;
+    }
+
+    float& hysteresisState = channelState[channel].hysteresis;
+
+    // The continuity state below only matters when switching to Type I.
+    // Its smoothers decay below -55 dB within 128 samples, so only the
+    // tail of the chunk needs to feed them
+    const int tailStart = std::max(0, numSamples - 128);
 
     switch (tapeType)
     {
         case TapeType::TypeI:
         {
-            // Ferric: warmer, more saturation, even harmonics
-            drive *= 1.3f;
-            float saturated = DSPUtils::hysteresis(biasedInput * drive, hysteresisState, saturationAmount);
-            return saturated * 0.8f;  // Compensate for drive
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = processHysteresis((data[i] + biasOffset) * drive, channel);
+            break;
         }
 
         case TapeType::TypeII:
         {
             // Chrome: cleaner, less distortion
-            drive *= 0.9f;
-            float saturated = std::tanh(biasedInput * drive);
+            if (antiderivativeActive)
+                processAntiderivativeSaturation(data, numSamples, biasOffset, drive, channel);
+            else
+                kernels->tanhSaturate(data, numSamples, biasOffset, drive, useFastTanh);
+
             // Update hysteresis state for continuity
-            hysteresisState = hysteresisState * 0.9f + saturated * 0.1f;
-            return saturated;
+            for (int i = tailStart; i < numSamples; ++i)
+                hysteresisState = hysteresisState * 0.9f + data[i] * 0.1f;
+            break;
         }
 
         case TapeType::Modern:
         {
-            // Modern: cleanest, most headroom
-            drive *= 0.7f;
-            float saturated = biasedInput * drive;
-            // Very gentle soft clipping
-            if (std::abs(saturated) > 0.7f)
-            {
-                float sign = (saturated > 0.0f) ? 1.0f : -1.0f;
-                saturated = sign * (0.7f + std::tanh((std::abs(saturated) - 0.7f) * 2.0f) * 0.3f);
-            }
-            hysteresisState = hysteresisState * 0.95f + saturated * 0.05f;
-            return saturated;
+            // Modern: cleanest, most headroom, very gentle soft clipping
+            if (antiderivativeActive)
+                processAntiderivativeSaturation(data, numSamples, biasOffset, drive, channel);
+            else
+                kernels->softKneeSaturate(data, numSamples, biasOffset, drive, useFastTanh);
+
+            for (int i = tailStart; i < numSamples; ++i)
+                hysteresisState = hysteresisState * 0.95f + data[i] * 0.05f;
+            break;
         }
+    }
 
-        default:
-            return std::tanh(biasedInput * drive);
+    if (numScopePoints > 0)
+    {
+        for (int i = 0; i < numScopePoints; ++i)
+            scopePoints[i].output = data[firstScopeSample + i * scopeStride];
+
+        transferScope.push(scopePoints, numScopePoints);
     }
 }
 
-float TapeProcessor::processHeadBump(float input, int channel)
+void TapeProcessor::process(juce::AudioBuffer<float>& buffer)
 {
-    BiquadState& state = (channel == 0) ? headBumpStateL : headBumpStateR;
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+
+    if (numChannels == 0 || numSamples == 0 || ! isAllocated())
+        return;
+
+    TAPEWARM_PROFILE(profiler.beginBlock());
+
+    // Measure input level
+    float inLevel = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+        inLevel = std::max(inLevel, buffer.getMagnitude(ch, 0, numSamples));
+    inputLevel.store(inLevel);
+
+    const int numProcessed = std::min(numChannels, MAX_CHANNELS);
 
-    // Biquad filter processing
-    float output = headBumpB0 * input + headBumpB1 * state.x1 + headBumpB2 * state.x2
-                 - headBumpA1 * state.y1 - headBumpA2 * state.y2;
+    // Fully bypassed: nothing but the dry delay, so the output stays
+    // latency aligned and matches the input's level
+    bypassActive = bypassed && control->bypassFade >= 1.0f;
+    if (bypassActive)
+    {
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::Metering));
+        processBypassed(buffer, numProcessed, numSamples);
+        outputLevel.store(inLevel);
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::DryDelay));
+        TAPEWARM_PROFILE(profiler.endBlock(numSamples, currentSampleRate));
+        return;
+    }
 
-    // Update state
-    state.x2 = state.x1;
-    state.x1 = input;
-    state.y2 = state.y1;
-    state.y1 = output;
+    // Coming out of bypass, the chain fades in from silence rather than from
+    // the state it stopped with
+    if (control->bypassFade >= 1.0f)
+        resetChain();
 
-    return output;
+    const bool dualMono = (numProcessed == 2) && detectDualMono(buffer, numSamples);
+    dualMonoActive = dualMono;
+    TAPEWARM_PROFILE(profiler.lap(StageProfiler::Metering));
+
+    // The stages run on chunks of up to MAX_BLOCK_SIZE samples, while
+    // modulation and coefficient updates keep to a fixed control-rate grid,
+    // independent of the host buffer size
+    for (int start = 0; start < numSamples; start += MAX_BLOCK_SIZE)
+        processChunk(buffer, numProcessed, start, std::min(MAX_BLOCK_SIZE, numSamples - start), dualMono);
+
+    // Measure output level
+    float outLevel = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+        outLevel = std::max(outLevel, buffer.getMagnitude(ch, 0, numSamples));
+    outputLevel.store(outLevel);
+
+    TAPEWARM_PROFILE(profiler.lap(StageProfiler::Metering));
+    TAPEWARM_PROFILE(profiler.endBlock(numSamples, currentSampleRate));
 }
 
-float TapeProcessor::processHFRolloff(float input, int channel)
+bool TapeProcessor::detectDualMono(const juce::AudioBuffer<float>& buffer, int numSamples)
 {
-    if (channel == 0)
+    // Mono sources routed as stereo: compare bit patterns, so -0/+0 or NaN
+    // differences still count as distinct channels
+    const auto numBytes = sizeof(float) * static_cast<size_t>(numSamples);
+    if (std::memcmp(buffer.getReadPointer(0), buffer.getReadPointer(1), numBytes) != 0)
     {
-        hfRolloffStateL += hfRolloffCoeffL * (input - hfRolloffStateL);
-        return hfRolloffStateL;
+        if (control->channelsLinked)
+            unlinkChannels();
+
+        control->identicalSamples = 0;
+        control->relinkRemaining = 0;
+        control->channelsLinked = false;
+        return false;
     }
-    else
+
+    if (!control->channelsLinked)
     {
-        hfRolloffStateR += hfRolloffCoeffR * (input - hfRolloffStateR);
-        return hfRolloffStateR;
+        // Wait until the delay line and filters have been fed identical input
+        // for long enough that the channels have nearly converged, then fade
+        // channel 1 over to channel 0 (processChunk links them at the end)
+        if (control->identicalSamples < delaySize)
+        {
+            control->identicalSamples += numSamples;
+            if (control->identicalSamples >= delaySize)
+                control->relinkRemaining = RELINK_FADE_SAMPLES;
+        }
+
+        return false;
     }
+
+    return true;
 }
 
-float TapeProcessor::processWowFlutter(float input, int channel)
+void TapeProcessor::unlinkChannels()
 {
-    // Write input to delay line
-    writeToDelayLine(input, channel);
+    // Channel 1's convolution history is not mirrored while linked (too
+    // large per chunk), so it is caught up once here
+    if (responseMode == ResponseMode::Convolution)
+        convolver.copyChannel(0, 1);
+
+    // Its oversampling filters were skipped too: their state only depends
+    // on recent input, so running channel 0's recent saturation input
+    // through them rebuilds it. The saturation state is put back afterwards
+    auto* oversampler = activeOversamplers[1];
+    if (oversampler == nullptr)
+        return;
 
-    // Calculate wow modulation (slow sine with randomness)
-    float wowMod = std::sin(wowPhase * 2.0f * juce::MathConstants<float>::pi);
-    wowMod += wowRandomOffset * std::sin(wowPhase * 1.7f * juce::MathConstants<float>::pi);  // Irregular
-    wowMod *= wowDepth;
+    static_assert(OVERSAMPLER_HISTORY <= MAX_BLOCK_SIZE, "History is replayed in one pass");
+    float replay[OVERSAMPLER_HISTORY];
+    float* replayChannels[] = { replay };
 
-    // Calculate flutter modulation (fast with randomness)
-    float flutterMod = std::sin(flutterPhase * 2.0f * juce::MathConstants<float>::pi);
-    flutterMod += flutterRandomOffset * std::sin(flutterPhase * 2.3f * juce::MathConstants<float>::pi);
-    flutterMod *= flutterDepth;
+    for (int i = 0; i < OVERSAMPLER_HISTORY; ++i)
+        replay[i] = oversamplerHistory[(control->historyIndex + i) & (OVERSAMPLER_HISTORY - 1)];
 
-    // Age increases the effect
-    float ageBoost = 1.0f + ageAmount * 0.5f;
-    float totalModulation = (wowMod + flutterMod) * ageBoost;
+    const ChannelState linkedState = channelState[1];
+    juce::dsp::AudioBlock<float> replayBlock(replayChannels, 1, static_cast<size_t>(OVERSAMPLER_HISTORY));
 
-    // Convert modulation to delay time (base delay + modulation)
-    float delaySamples = (baseDelayMs + totalModulation) * static_cast<float>(currentSampleRate) / 1000.0f;
-    delaySamples = std::clamp(delaySamples, 1.0f, static_cast<float>(delayLineL.size() - 2));
+    oversampler->reset();
+    auto oversampledBlock = oversampler->processSamplesUp(replayBlock);
+    processSaturation(oversampledBlock.getChannelPointer(0), static_cast<int>(oversampledBlock.getNumSamples()), 1);
+    oversampler->processSamplesDown(replayBlock);
 
-    return readFromDelayLine(delaySamples, channel);
+    channelState[1] = linkedState;
 }
 
-float TapeProcessor::processHiss()
+void TapeProcessor::processRelinkFade(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
-    // Generate noise
-    float noise = noiseGen.nextSample();
+    const float* source = buffer.getReadPointer(0, startSample);
+    float* destination = buffer.getWritePointer(1, startSample);
+    const float step = 1.0f / static_cast<float>(RELINK_FADE_SAMPLES);
 
-    // Shape the noise spectrum (tape hiss has specific character)
-    // Filter to emphasize mid-high frequencies
-    float shaped = noise * 0.7f;
+    // Channel 1's own output fades out linearly; the rest of the chunk
+    // after the fade is channel 0's
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float own = static_cast<float>(std::max(0, control->relinkRemaining - i - 1)) * step;
+        destination[i] = source[i] + (destination[i] - source[i]) * own;
+    }
 
-    return shaped * hissLevel;
+    control->relinkRemaining = std::max(0, control->relinkRemaining - numSamples);
+    if (control->relinkRemaining > 0)
+        return;
+
+    // Channel 1 now carries channel 0's output, so it takes its state too
+    mirrorChannelState(delaySize, true);
+    control->channelsLinked = true;
 }
 
-void TapeProcessor::process(juce::AudioBuffer<float>& buffer)
+void TapeProcessor::mirrorChannelState(int numSamples, bool copyDelayLine)
 {
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
+    channelState[1] = channelState[0];
 
-    if (numChannels == 0 || numSamples == 0)
+    if (!copyDelayLine)
         return;
 
-    // Measure input level
-    float inLevel = 0.0f;
-    for (int ch = 0; ch < numChannels; ++ch)
-        inLevel = std::max(inLevel, buffer.getMagnitude(ch, 0, numSamples));
-    inputLevel.store(inLevel);
+    if (numSamples >= delaySize)
+    {
+        std::copy(channelBuffers[0].delayLine, channelBuffers[0].delayLine + delaySize, channelBuffers[1].delayLine);
+        return;
+    }
 
-    // Process each sample
-    for (int i = 0; i < numSamples; ++i)
+    // Only the region written by this chunk has changed
+    const int firstPart = std::min(numSamples, delaySize - control->writeIndex);
+    const float* source = channelBuffers[0].delayLine;
+    float* destination = channelBuffers[1].delayLine;
+
+    std::copy(source + control->writeIndex, source + control->writeIndex + firstPart, destination + control->writeIndex);
+    std::copy(source, source + (numSamples - firstPart), destination);
+}
+
+void TapeProcessor::scheduleSegments(int numSamples)
+{
+    numSegments = 0;
+
+    for (int start = 0; start < numSamples;)
     {
-        // Advance LFOs once per sample
-        wowPhase += wowPhaseIncrement;
-        if (wowPhase >= 1.0f) wowPhase -= 1.0f;
+        if (control->samplesUntilTick == 0)
+        {
+            updateControlRate();
+            control->samplesUntilTick = CONTROL_BLOCK_SIZE;
+        }
+
+        const int length = std::min(control->samplesUntilTick, numSamples - start);
+
+        auto& segment = segments[numSegments++];
+        segment.start = start;
+        segment.length = length;
+        segment.inputGain = control->inputGain;
+        segment.outputGain = control->outputGain;
+        segment.mix = control->mix;
+        segment.responseMix = control->responseMix;
+        segment.headBump = control->headBump;
+        std::copy(std::begin(control->playbackLoss), std::end(control->playbackLoss), std::begin(segment.playbackLoss));
+
+        // Per-sample modulation and noise shared by both channels
+        computeWowFlutterDelays(start, length);
+        if (hissLevel > 0.0f)
+            generateHiss(start, length);
+
+        control->samplesUntilTick -= length;
+        control->position += length;
+        start += length;
+    }
+
+    // Same hiss on both channels with a slight stereo difference
+    if (hissLevel > 0.0f)
+        kernels->mix(hissRight, hissLeft, numSamples, 0.9f, 0.1f);
+}
 
-        flutterPhase += flutterPhaseIncrement;
-        if (flutterPhase >= 1.0f) flutterPhase -= 1.0f;
+template <typename Equal, typename Process>
+void TapeProcessor::forEachRun(Equal&& equal, Process&& process) const
+{
+    for (int first = 0, next = 1; first < numSegments; first = next++)
+    {
+        while (next < numSegments && equal(segments[first], segments[next]))
+            ++next;
+
+        const auto& last = segments[next - 1];
+        process(segments[first], segments[first].start, last.start + last.length - segments[first].start);
+    }
+}
 
-        // Occasionally update random offsets for natural variation
-        if (i % 1000 == 0)
+void TapeProcessor::processChunk(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples, bool dualMono)
+{
+    scheduleSegments(numSamples);
+    TAPEWARM_PROFILE(profiler.lap(StageProfiler::Control));
+
+    processDryDelay(buffer, numChannels, startSample, numSamples);
+    TAPEWARM_PROFILE(profiler.lap(StageProfiler::DryDelay));
+
+    // Channels that go through the tape chain; a dual-mono pair only needs one
+    const int numChainChannels = dualMono ? 1 : numChannels;
+
+    const auto sameInputGain = [](const SegmentControl& a, const SegmentControl& b)
+    {
+        return juce::exactlyEqual(a.inputGain, b.inputGain);
+    };
+    const auto sameFilters = [](const SegmentControl& a, const SegmentControl& b)
+    {
+        return std::memcmp(&a.headBump, &b.headBump, sizeof(a.headBump)) == 0
+            && std::memcmp(a.playbackLoss, b.playbackLoss, sizeof(a.playbackLoss)) == 0;
+    };
+    const auto sameResponseMix = [](const SegmentControl& a, const SegmentControl& b)
+    {
+        return juce::exactlyEqual(a.responseMix, b.responseMix);
+    };
+    const auto sameMix = [](const SegmentControl& a, const SegmentControl& b)
+    {
+        return juce::exactlyEqual(a.outputGain, b.outputGain) && juce::exactlyEqual(a.mix, b.mix);
+    };
+
+    // Signal chain: Pre-emphasis -> Saturation -> De-emphasis -> Head Bump -> Head Losses -> Wow/Flutter -> Hiss
+
+    const bool wowFlutterActive = (wowDepth > 0.0f || flutterDepth > 0.0f);
+
+    // The convolution only runs while some of it is blended in. Its history
+    // goes stale while it is skipped, so it restarts from silence, under the
+    // blend's fade in
+    const bool convolutionActive = responseMode == ResponseMode::Convolution
+        && std::any_of(segments, segments + numSegments, [](const SegmentControl& segment) { return segment.responseMix > 0.0f; });
+
+    if (convolutionActive && convolutionIdle)
+        convolver.reset();
+    convolutionIdle = ! convolutionActive;
+
+    for (int ch = 0; ch < numChainChannels; ++ch)
+    {
+        float* channelData = buffer.getWritePointer(ch, startSample);
+        auto& state = channelState[ch];
+        auto& buffers = channelBuffers[ch];
+
+        // 1. Input drive, record pre-emphasis and tape saturation (with
+        // hysteresis), oversampled per quality tier
+        auto block = juce::dsp::AudioBlock<float>(buffer)
+                         .getSingleChannelBlock(static_cast<size_t>(ch))
+                         .getSubBlock(static_cast<size_t>(startSample), static_cast<size_t>(numSamples));
+
+        forEachRun(sameInputGain, [&block](const SegmentControl& segment, int start, int length)
         {
-            wowRandomOffset = wowRandomOffset * 0.99f + randomDist(rng) * 0.01f;
-            flutterRandomOffset = flutterRandomOffset * 0.99f + randomDist(rng) * 0.01f;
+            block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(length)).multiplyBy(segment.inputGain);
+        });
+
+        if (emphasis != EmphasisMode::Off)
+            kernels->biquad(channelData, numSamples, recordEmphasis, state.recordEmphasis);
+
+        if (auto* oversampler = activeOversamplers[ch])
+        {
+            // Channel 0's input is kept so that channel 1's filters, skipped
+            // while linked, can be caught up when the channels part
+            if (ch == 0)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    oversamplerHistory[(control->historyIndex + i) & (OVERSAMPLER_HISTORY - 1)] = channelData[i];
+                control->historyIndex = (control->historyIndex + numSamples) & (OVERSAMPLER_HISTORY - 1);
+            }
+
+            auto oversampledBlock = oversampler->processSamplesUp(block);
+            processSaturation(oversampledBlock.getChannelPointer(0), static_cast<int>(oversampledBlock.getNumSamples()), ch);
+            oversampler->processSamplesDown(block);
+        }
+        else
+        {
+            processSaturation(channelData, numSamples, ch);
         }
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::Saturation));
 
-        // Generate hiss (same for both channels, slight decorrelation applied later)
-        float hissL = processHiss();
-        float hissR = hissL * 0.9f + processHiss() * 0.1f;  // Slight stereo difference
+        // Head bump (low frequency boost): the machine's full response,
+        // blended in by the head bump amount, runs on its own first (the
+        // stages commute); otherwise the biquad joins the cascade below
+        if (convolutionActive)
+        {
+            std::copy(channelData, channelData + numSamples, responseDry);
+            convolver.process(*machineResponse, ch, channelData, numSamples, *kernels);
 
-        for (int ch = 0; ch < numChannels; ++ch)
+            forEachRun(sameResponseMix, [&](const SegmentControl& segment, int start, int length)
+            {
+                kernels->mix(channelData + start, responseDry + start, length, 1.0f - segment.responseMix, segment.responseMix);
+            });
+        }
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::HeadBump));
+
+        // 2-3. Playback de-emphasis, head bump and head losses: the linear
+        // stages after saturation run as one biquad cascade, in a single pass
+        // over each run of segments with the same coefficients
+        forEachRun(sameFilters, [&](const SegmentControl& segment, int start, int length)
         {
-            float* channelData = buffer.getWritePointer(ch);
-            float dry = channelData[i];
+            const TapeKernels::BiquadCoefficients* sections[TapeKernels::MAX_CASCADE_SECTIONS];
+            TapeKernels::BiquadState* sectionStates[TapeKernels::MAX_CASCADE_SECTIONS];
+            int numSections = 0;
+
+            const auto addSection = [&](const TapeKernels::BiquadCoefficients& coeffs, TapeKernels::BiquadState& sectionState)
+            {
+                sections[numSections] = &coeffs;
+                sectionStates[numSections] = &sectionState;
+                ++numSections;
+            };
+
+            if (emphasis != EmphasisMode::Off)
+                addSection(playbackEmphasis, state.playbackEmphasis);
+            if (responseMode == ResponseMode::Filters && headBumpAmount > 0.0f)
+                addSection(segment.headBump, state.headBump);
+            for (int s = 0; s < PlaybackLoss::NUM_SECTIONS; ++s)
+                addSection(segment.playbackLoss[s], state.playbackLoss[s]);
+
+            kernels->biquadCascade(channelData + start, length, sections, sectionStates, numSections);
+        });
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::FilterCascade));
+
+        // 4. Wow & Flutter (pitch modulation)
+        if (wowFlutterActive)
+            kernels->modulatedDelay(channelData, buffers.delayLine, delaySize, control->writeIndex,
+                                    delayTimes, numSamples, model->cubicInterpolation);
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::WowFlutter));
+    }
 
-            // Apply input drive
-            float sample = dry * inputGainLinear;
+    if (dualMono)
+    {
+        buffer.copyFrom(1, startSample, buffer, 0, startSample, numSamples);
+        mirrorChannelState(numSamples, wowFlutterActive);
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::WowFlutter));
+    }
+    else if (control->relinkRemaining > 0 && numChannels == 2)
+    {
+        processRelinkFade(buffer, startSample, numSamples);
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::WowFlutter));
+    }
 
-            // Signal chain: Saturation -> Head Bump -> HF Rolloff -> Wow/Flutter -> Hiss
+    if (pathPadding > 0)
+    {
+        processPathDelay(buffer, numChannels, startSample, numSamples);
+        TAPEWARM_PROFILE(profiler.lap(StageProfiler::Saturation));
+    }
 
-            // 1. Tape saturation (with hysteresis)
-            if (saturationAmount > 0.0f)
-                sample = processSaturation(sample, ch);
+    // Hiss and the dry/wet mix differ per channel, so they run after mirroring
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* channelData = buffer.getWritePointer(ch, startSample);
+        const float* dry = channelBuffers[ch].dry;
+
+        // 5. Add tape hiss (shaped to emphasise its character)
+        if (hissLevel > 0.0f)
+            kernels->addScaled(channelData, (ch == 0) ? hissLeft : hissRight, numSamples, hissLevel * 0.7f);
+
+        // Apply output gain and mix dry/wet
+        forEachRun(sameMix, [&](const SegmentControl& segment, int start, int length)
+        {
+            kernels->mix(channelData + start, dry + start, length, 1.0f - segment.mix, segment.outputGain * segment.mix);
+        });
+    }
 
-            // 2. Head bump (low frequency boost)
-            if (headBumpAmount > 0.0f)
-                sample = processHeadBump(sample, ch);
+    if (bypassed || control->bypassFade > 0.0f)
+        processBypassFade(buffer, numChannels, startSample, numSamples);
 
-            // 3. HF rolloff
-            sample = processHFRolloff(sample, ch);
+    // Advance delay line write index
+    control->writeIndex = (control->writeIndex + numSamples) % delaySize;
+    TAPEWARM_PROFILE(profiler.lap(StageProfiler::HissMix));
+}
 
-            // 4. Wow & Flutter (pitch modulation)
-            if (wowDepth > 0.0f || flutterDepth > 0.0f)
-                sample = processWowFlutter(sample, ch);
+void TapeProcessor::processDryDelay(const juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples)
+{
+    // Keep a copy of the dry signal, delayed by the oversampling latency so
+    // the mix stage stays aligned
+    constexpr int mask = DRY_DELAY_SIZE - 1;
+    const int writeStart = control->dryWriteIndex;
 
-            // 5. Add tape hiss
-            if (hissLevel > 0.0f)
-                sample += (ch == 0) ? hissL : hissR;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* input = buffer.getReadPointer(ch, startSample);
+        float* dry = channelBuffers[ch].dry;
 
-            // Apply output gain
-            sample *= outputGainLinear;
+        if (latencySamples == 0)
+        {
+            std::copy(input, input + numSamples, dry);
+            continue;
+        }
 
-            // Mix dry/wet
-            channelData[i] = dry * (1.0f - mixAmount) + sample * mixAmount;
+        float* line = channelBuffers[ch].dryDelay;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            line[(writeStart + i) & mask] = input[i];
+            dry[i] = line[(writeStart + i - latencySamples) & mask];
         }
+    }
 
-        // Advance delay line write index
-        writeIndex = (writeIndex + 1) % static_cast<int>(delayLineL.size());
+    control->dryWriteIndex = (writeStart + numSamples) & mask;
+}
+
+void TapeProcessor::processPathDelay(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples)
+{
+    // Delays the chain's output by what the active saturation path is short
+    // of the reported latency. The stages after saturation are linear, so
+    // this stands in for a delay right after it
+    constexpr int mask = DRY_DELAY_SIZE - 1;
+    const int writeStart = control->pathWriteIndex;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* data = buffer.getWritePointer(ch, startSample);
+        float* line = channelBuffers[ch].pathDelay;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            line[(writeStart + i) & mask] = data[i];
+            data[i] = line[(writeStart + i - pathPadding) & mask];
+        }
     }
 
-    // Measure output level
-    float outLevel = 0.0f;
+    control->pathWriteIndex = (writeStart + numSamples) & mask;
+}
+
+void TapeProcessor::processBypassFade(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples)
+{
+    // Equal-power crossfade between the chain's output and the aligned dry
+    // signal, toward whichever side bypass is now on
+    const float step = bypassed ? bypassFadeStep : -bypassFadeStep;
+    float fade = control->bypassFade;
+
     for (int ch = 0; ch < numChannels; ++ch)
-        outLevel = std::max(outLevel, buffer.getMagnitude(ch, 0, numSamples));
-    outputLevel.store(outLevel);
+    {
+        float* channelData = buffer.getWritePointer(ch, startSample);
+        const float* dry = channelBuffers[ch].dry;
+        fade = control->bypassFade;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            fade = std::clamp(fade + step, 0.0f, 1.0f);
+            const float angle = fade * juce::MathConstants<float>::halfPi;
+            channelData[i] = channelData[i] * std::cos(angle) + dry[i] * std::sin(angle);
+        }
+    }
+
+    control->bypassFade = fade;
+}
+
+void TapeProcessor::processBypassed(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+{
+    // The dry delay alone, in place; it keeps running so the crossfade back
+    // in starts from an aligned dry signal
+    constexpr int mask = DRY_DELAY_SIZE - 1;
+    const int writeStart = control->dryWriteIndex;
+
+    if (latencySamples > 0)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = buffer.getWritePointer(ch);
+            float* line = channelBuffers[ch].dryDelay;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                line[(writeStart + i) & mask] = data[i];
+                data[i] = line[(writeStart + i - latencySamples) & mask];
+            }
+        }
+    }
+
+    control->dryWriteIndex = (writeStart + numSamples) & mask;
+    control->position += numSamples;
 }
@@ -2,28 +2,22 @@
 
 #include <JuceHeader.h>
 #include "DSPUtils.h"
-#include <vector>
+#include "TapeKernels.h"
+#include "TapeModel.h"
+#include "MachineResponse.h"
+#include "PlaybackLoss.h"
+#include "StageProfiler.h"
+#include "TransferScope.h"
 #include <random>
 
-// Machine speed types
-enum class MachineType
-{
-    IPS_7_5 = 0,   // 7.5 IPS - warmest, most head bump
-    IPS_15,         // 15 IPS - balanced
-    IPS_30          // 30 IPS - cleanest, most extended
-};
-
-// Tape formulation types
-enum class TapeType
-{
-    TypeI = 0,      // Ferric - classic warm, more saturation
-    TypeII,         // Chrome - brighter, cleaner
-    Modern          // Modern formulation - extended response
-};
-
 class TapeProcessor
 {
 public:
+    // Construction only sets up parameters: the arena and oversamplers are
+    // allocated by the first prepare(). prepare() may also allocate
+    // convolution history and build the shared responses for a new sample
+    // rate; process() never allocates, and passes audio through untouched
+    // until the first prepare()
     TapeProcessor();
     ~TapeProcessor() = default;
 
@@ -48,29 +42,305 @@ public:
     // Type selectors
     void setMachineType(int type);
     void setTapeType(int type);
+    void setResponseMode(int mode);
+    void setEmphasis(int mode);
+
+    // The quality tier and anti-aliasing mode set the latency, so they take
+    // effect at the next prepare() rather than while processing
+    void setQuality(int mode);
+    void setAntialiasing(int mode);
+
+    // Equal-power crossfade to the latency-aligned dry signal; once it
+    // completes only the dry delay runs, until bypass is turned off
+    void setBypassed(bool shouldBypass);
+
+    // Offline rendering: wow/flutter phases, their random walk and the hiss
+    // follow the absolute sample position and the seed rather than free
+    // running state, so separately processed ranges of a file join up.
+    // Call setTimeline() before prepare() and seekTimeline() after it, at a
+    // multiple of TIMELINE_ALIGNMENT
+    void setTimeline(uint32_t seed);
+    void seekTimeline(int64_t samplePosition);
+    static constexpr int TIMELINE_ALIGNMENT = 128;
+
+    // Latency of the slowest saturation path the prepared quality and
+    // anti-aliasing can switch to (Type I keeps oversampling under ADAA);
+    // faster paths are padded to it, so it is fixed from one prepare() to
+    // the next whatever the tape type
+    int getLatencySamples() const { return latencySamples; }
+
+    // Optional stages that ran in the last block (for tracing)
+    enum ActiveStage : uint32_t
+    {
+        OversamplingStage   = 1 << 0,
+        HeadBumpStage       = 1 << 1,
+        WowFlutterStage     = 1 << 2,
+        HissStage           = 1 << 3,
+        DualMonoStage       = 1 << 4,   // Chain ran once for both channels
+        AntiderivativeStage = 1 << 5,   // Saturation used ADAA instead of oversampling
+        ConvolutionStage    = 1 << 6,   // Machine response convolution instead of the head bump biquad
+        BypassedStage       = 1 << 7    // Only the dry delay ran
+    };
+
+    uint32_t getActiveStages() const;
+
+    // Instruction set of the kernels picked in prepare() (for diagnostics)
+    const char* getKernelName() const { return kernels != nullptr ? kernels->name : "None"; }
+
+    // Coefficient design, shared with TapeBank (amounts normalised to 0-1)
+    static TapeKernels::BiquadCoefficients calculateHeadBumpCoefficients(const TapeModel& model, float frequency,
+                                                                         float amount, double sampleRate);
+    static void calculatePlaybackLoss(const TapeModel& model, float warmthLevel, float ageLevel, double sampleRate,
+                                      TapeKernels::BiquadCoefficients (&sections)[PlaybackLoss::NUM_SECTIONS]);
+
+    // Record pre-emphasis for a standard and speed, and the playback
+    // de-emphasis that is its exact inverse (both unity when Off)
+    static void calculateEmphasis(EmphasisMode mode, MachineType machineType, double sampleRate,
+                                  TapeKernels::BiquadCoefficients& record, TapeKernels::BiquadCoefficients& playback);
+
+    // Memory held by this instance, and by the models shared across instances
+    struct MemoryFootprint
+    {
+        size_t perInstance = 0;
+        size_t shared = 0;
+    };
+
+    MemoryFootprint getMemoryFootprint() const;
+
+    // Saturation input/output pairs for the editor's XY display
+    TransferScope& getTransferScope() { return transferScope; }
+
+#if TAPEWARM_PROFILING
+    // Per-stage timings of process(), readable from any thread
+    const StageProfiler& getProfiler() const { return profiler; }
+#endif
 
     // Metering
     float getInputLevel() const { return inputLevel.load(); }
     float getOutputLevel() const { return outputLevel.load(); }
 
 private:
+    // Buffers are preallocated for this rate; higher rates get a shorter
+    // (still sufficient) wow/flutter delay line
+    static constexpr double MAX_SAMPLE_RATE = 192000.0;
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int CONTROL_BLOCK_SIZE = 32;       // Control-rate tick interval in samples
+    static constexpr int RANDOM_WALK_TICKS = 31;        // Wow/flutter random walk every ~1000 samples
+    static constexpr int MAX_BLOCK_SIZE = 512;          // Longest chunk the stages run on in one pass
+    static constexpr int MAX_SEGMENTS = MAX_BLOCK_SIZE / CONTROL_BLOCK_SIZE + 1;   // Control segments per chunk
+    static constexpr int MAX_DELAY_SAMPLES = 9600;      // 50ms at MAX_SAMPLE_RATE
+    static constexpr int DRY_DELAY_SIZE = 256;          // Power of two, covers the HQ oversampling latency
+    static constexpr int OVERSAMPLER_HISTORY = 512;     // Power of two, longer than the oversampling filters' memory
+    static constexpr int RELINK_FADE_SAMPLES = 256;     // Channel 1 fades over to channel 0 before linking
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr double BYPASS_FADE_SECONDS = 0.02;
+    static constexpr double EMPHASIS_HIGH_SHELF = 4.0;  // Record HF boost limit (+12 dB)
+    static constexpr double EMPHASIS_LOW_SHELF = 2.0;   // NAB LF cut limit (-6 dB), so playback lifts bias DC little
+    static constexpr double WARMTH_DEPTH = 2.0;         // Recorded depth added at Warmth 100% (um), as with overbias
+    static constexpr double AGE_SPACING = 1.0;          // Head-to-tape spacing added at Age 100% (um): wear, oxide build-up
+
+    // Processes up to MAX_BLOCK_SIZE samples, starting at startSample. Each
+    // stage runs over the whole chunk, using the control values recorded for
+    // the segments between ticks. With dualMono set, the tape chain runs on
+    // channel 0 only and is mirrored
+    void processChunk(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples, bool dualMono);
+
+    // Runs the control-rate ticks that fall within the next numSamples and
+    // records each segment's values; also fills the delay times and hiss
+    void scheduleSegments(int numSamples);
+
+    // Calls process(segment, start, length) once per run of consecutive
+    // segments that equal() finds the same, so stages whose control values
+    // have settled run over the chunk in a single pass
+    template <typename Equal, typename Process>
+    void forEachRun(Equal&& equal, Process&& process) const;
+
+    // True when both channels are bit-identical and their state is linked
+    bool detectDualMono(const juce::AudioBuffer<float>& buffer, int numSamples);
+    void mirrorChannelState(int numSamples, bool copyDelayLine);
+
+    // Brings channel 1's convolution and oversampling state, skipped while
+    // linked, up to date from channel 0's
+    void unlinkChannels();
+
+    // Crossfades channel 1's chain output to channel 0's, then links them
+    void processRelinkFade(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
     // Processing stages
-    float processSaturation(float input, int channel);
-    float processHeadBump(float input, int channel);
-    float processHFRolloff(float input, int channel);
-    float processWowFlutter(float input, int channel);
-    float processHiss();
+    void processDryDelay(const juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples);
+    void processPathDelay(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples);
+    void processBypassFade(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples);
+    void processBypassed(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
+    void processSaturation(float* data, int numSamples, int channel);
+    void processAntiderivativeSaturation(float* data, int numSamples, float offset, float drive, int channel);
+    float processHysteresis(float input, int channel);
+    void updateControlRate();
+    void computeWowFlutterDelays(int start, int numSamples);
+    void generateHiss(int start, int numSamples);
 
     // Filter coefficient updates
     void updateHeadBumpFilter();
-    void updateHFRolloffFilter();
+    void updatePlaybackLossFilter();
     void updateWowFlutterLFO();
+    void updateQualitySettings();
+    void updateModel();
+    void updateEmphasisFilter();
+
+    // Heavy state (arena, oversamplers), built on the first prepare()
+    void allocateResources();
+    bool isAllocated() const { return arena.get() != nullptr; }
+
+    // Clears the tape chain's state but not the dry delay or the timeline
+    void resetChain();
+
+    // Carves all per-sample state and buffers out of the arena
+    void allocateArena();
+
+    // Points machineResponse at the current machine's shared response
+    void updateMachineResponse();
+
+    //==============================================================================
+    // Hot state, carved from the arena on cache line boundaries
+
+    // Per-channel filter and saturation state (cache line aligned per channel)
+    struct alignas(64) ChannelState
+    {
+        float hysteresis = 0.0f;                // Saturation state (hysteresis)
+        TapeKernels::BiquadState headBump;      // Head bump biquad
+        TapeKernels::BiquadState recordEmphasis;
+        TapeKernels::BiquadState playbackEmphasis;
+        TapeKernels::BiquadState playbackLoss[PlaybackLoss::NUM_SECTIONS];
+        DSPUtils::AntiderivativeState antiderivative;  // ADAA input history
+    };
+
+    // Control-rate scheduler: LFO phases, smoothed coefficients and delay
+    // line write heads shared by both channels
+    struct alignas(64) ControlState
+    {
+        int samplesUntilTick = 0;               // Samples left in the current control block
+        int randomWalkTicks = 0;
+        int64_t position = 0;                   // Absolute position of the next segment (timeline)
+        int writeIndex = 0;                     // Wow/flutter delay line
+        int dryWriteIndex = 0;                  // Dry compensation delay
+        int pathWriteIndex = 0;                 // Saturation path padding
+        float wowPhase = 0.0f;
+        float flutterPhase = 0.0f;
+        float delayStart = 0.0f;                // Wow/flutter delay at the previous tick (samples)
+        float delayEnd = 0.0f;                  // ...and at the next tick
+        float inputGain = 1.0f;                 // Smoothed toward the block-rate targets
+        float outputGain = 1.0f;
+        float mix = 1.0f;
+        float responseMix = 0.5f;               // Machine response blend (head bump amount)
+        float bypassFade = 0.0f;                // 0 processing, 1 bypassed
+        TapeKernels::BiquadCoefficients headBump;
+        TapeKernels::BiquadCoefficients playbackLoss[PlaybackLoss::NUM_SECTIONS];
+        int identicalSamples = 0;               // Run of bit-identical L/R input
+        int relinkRemaining = 0;                // Samples left in the fade before linking
+        int historyIndex = 0;                   // Oversampler input history
+        bool channelsLinked = true;             // Channel 1 state mirrors channel 0
+    };
+
+    // Control values in effect between two ticks, recorded per chunk
+    struct SegmentControl
+    {
+        int start = 0;                          // Offset into the chunk
+        int length = 0;
+        float inputGain = 1.0f;
+        float outputGain = 1.0f;
+        float mix = 1.0f;
+        float responseMix = 0.5f;
+        TapeKernels::BiquadCoefficients headBump;
+        TapeKernels::BiquadCoefficients playbackLoss[PlaybackLoss::NUM_SECTIONS];
+    };
+
+    // Per-channel buffers
+    struct ChannelBuffers
+    {
+        float* delayLine = nullptr;             // Wow/flutter pitch modulation, MAX_DELAY_SAMPLES
+        float* dryDelay = nullptr;              // Oversampling latency compensation, DRY_DELAY_SIZE
+        float* pathDelay = nullptr;             // Pads the faster saturation paths, DRY_DELAY_SIZE
+        float* dry = nullptr;                   // Latency-aligned dry chunk, MAX_BLOCK_SIZE
+    };
+
+    juce::HeapBlock<char> arena;
+    size_t arenaSize = 0;
+    ChannelState* channelState = nullptr;
+    ControlState* control = nullptr;
+    ChannelBuffers channelBuffers[MAX_CHANNELS];
+    SegmentControl* segments = nullptr;         // This chunk's segments, MAX_SEGMENTS
+    int numSegments = 0;
+    float* delayTimes = nullptr;                // Per-sample wow/flutter delay, MAX_BLOCK_SIZE
+    float* hissLeft = nullptr;                  // Hiss noise per channel, MAX_BLOCK_SIZE
+    float* hissRight = nullptr;
+    float* responseDry = nullptr;               // Input to the machine response, MAX_BLOCK_SIZE
+    float* oversamplerHistory = nullptr;        // Channel 0's oversampler input, OVERSAMPLER_HISTORY
+    TransferScope::Point* scopePoints = nullptr;    // Transfer curve pairs of a chunk, MAX_BLOCK_SIZE
+    int delaySize = 0;                          // Active wow/flutter delay line length
+
+    //==============================================================================
+    // Block-rate values: targets for the control-rate smoothing and
+    // derived values read once per segment
+
+    float inputGainLinear = 1.0f;
+    float outputGainLinear = 1.0f;
+    float saturationAmount = 0.5f;
+    float headBumpAmount = 0.5f;
+    float wowDepth = 0.0f;
+    float flutterDepth = 0.0f;
+    float hissLevel = 0.0f;
+    float mixAmount = 1.0f;
+    float ageAmount = 0.0f;
+    float biasAmount = 0.5f;
+    float warmthAmount = 0.5f;
+
+    // Head bump filter (biquad peak/bell) and the playback head losses
+    TapeKernels::BiquadCoefficients headBumpCoeffs;
+    TapeKernels::BiquadCoefficients playbackLossCoeffs[PlaybackLoss::NUM_SECTIONS];
+
+    // Record/playback emphasis (unity when off)
+    TapeKernels::BiquadCoefficients recordEmphasis;
+    TapeKernels::BiquadCoefficients playbackEmphasis;
+
+    // Wow (slow, 0.5-3 Hz) and flutter (fast, 5-30 Hz) LFOs
+    float wowPhaseIncrement = 0.0f;
+    float flutterPhaseIncrement = 0.0f;
+    float wowRandomOffset = 0.0f;
+    float flutterRandomOffset = 0.0f;
+    float baseDelayMs = 10.0f;  // Center delay for modulation
+
+    float controlSmoothing = 1.0f;  // Per-tick interpolation coefficient
+    float bypassFadeStep = 0.0f;    // Bypass crossfade advance per sample
+
+    // Quality-dependent solver settings
+    float hysteresisLag = 0.5f;     // Lag coefficient scaled for the oversampled rate
+    int hysteresisSteps = 1;        // Sub-steps per hysteresis update
+    int latencySamples = 0;
+    int pathPadding = 0;            // Samples the active saturation path is short of latencySamples
+    bool antiderivativeActive = false;  // Type II/Modern curves run with ADAA at 1x
+    bool dualMonoActive = false;    // Last block ran the chain once for both channels
+    bool bypassActive = false;      // Last block only ran the dry delay
+    bool convolutionIdle = false;   // Last chunk skipped the convolution (nothing blended in)
+
+    // Shared characteristics of the current machine/tape/quality
+    const TapeModel* model = nullptr;
+
+    // Hot kernels for the running CPU (picked in prepare)
+    const TapeKernels::KernelTable* kernels = nullptr;
+
+    // Current machine's impulse response (ResponseMode::Convolution)
+    const MachineResponseSet::Response* machineResponse = nullptr;
+
+    // Oversampling around the saturation stage (2x for Standard, 4x for HQ),
+    // one per channel so channel 1's can be skipped while linked
+    juce::dsp::Oversampling<float>* activeOversamplers[MAX_CHANNELS] = {};
+    int oversamplingFactor = 1;
+
+    // Noise generator for hiss
+    DSPUtils::NoiseGenerator noiseGen;
 
-    // Delay line for wow/flutter
-    void writeToDelayLine(float sample, int channel);
-    float readFromDelayLine(float delaySamples, int channel);
+    //==============================================================================
+    // Cold state: user-facing parameters and rarely touched objects
 
-    // Parameters
     float inputDrive = 0.0f;        // dB
     float saturation = 50.0f;       // 0-100
     float warmth = 50.0f;           // 0-100
@@ -86,78 +356,49 @@ private:
 
     MachineType machineType = MachineType::IPS_15;
     TapeType tapeType = TapeType::TypeI;
-
-    // Derived values
-    float inputGainLinear = 1.0f;
-    float outputGainLinear = 1.0f;
-    float saturationAmount = 0.5f;
-    float warmthAmount = 0.5f;
-    float headBumpAmount = 0.5f;
-    float wowDepth = 0.0f;
-    float flutterDepth = 0.0f;
-    float hissLevel = 0.0f;
-    float mixAmount = 1.0f;
-    float ageAmount = 0.0f;
-    float biasAmount = 0.5f;
+    QualityMode quality = QualityMode::Standard;                    // As prepared
+    AntialiasingMode antialiasing = AntialiasingMode::Oversampling;
+    QualityMode pendingQuality = QualityMode::Standard;             // For the next prepare()
+    AntialiasingMode pendingAntialiasing = AntialiasingMode::Oversampling;
+    ResponseMode responseMode = ResponseMode::Filters;
+    EmphasisMode emphasis = EmphasisMode::Off;
+    bool bypassed = false;
+    bool timeline = false;
+    uint32_t timelineSeed = 0;
 
     // Sample rate and block size
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    // Saturation state (hysteresis)
-    float hysteresisStateL = 0.0f;
-    float hysteresisStateR = 0.0f;
-
-    // Head bump filter (biquad peak/bell)
-    struct BiquadState
-    {
-        float x1 = 0.0f, x2 = 0.0f;
-        float y1 = 0.0f, y2 = 0.0f;
-    };
-    BiquadState headBumpStateL, headBumpStateR;
-    float headBumpB0 = 1.0f, headBumpB1 = 0.0f, headBumpB2 = 0.0f;
-    float headBumpA1 = 0.0f, headBumpA2 = 0.0f;
-
-    // HF rolloff filter (one-pole lowpass per channel)
-    float hfRolloffCoeffL = 0.5f;
-    float hfRolloffStateL = 0.0f;
-    float hfRolloffCoeffR = 0.5f;
-    float hfRolloffStateR = 0.0f;
-
-    // Warmth filter (low shelf)
-    BiquadState warmthStateL, warmthStateR;
-    float warmthB0 = 1.0f, warmthB1 = 0.0f, warmthB2 = 0.0f;
-    float warmthA1 = 0.0f, warmthA2 = 0.0f;
-
-    // Wow LFO (slow, 0.5-3 Hz)
-    float wowPhase = 0.0f;
     float wowRate = 1.0f;       // Hz
-    float wowPhaseIncrement = 0.0f;
-
-    // Flutter LFO (fast, 5-30 Hz)
-    float flutterPhase = 0.0f;
     float flutterRate = 10.0f;  // Hz
-    float flutterPhaseIncrement = 0.0f;
 
-    // Random modulation for realistic wow/flutter
+    // Keeps the process-wide model set alive while this instance exists
+    std::shared_ptr<const TapeModelSet> models;
+
+    // Machine impulse responses shared by every instance at this sample
+    // rate (set in prepare), and this instance's convolution history
+    // (~40 KB per channel at 48 kHz)
+    std::shared_ptr<const MachineResponseSet> responses;
+    MachineConvolver convolver;
+
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversamplers2x[MAX_CHANNELS];
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversamplers4x[MAX_CHANNELS];
+
+    // Random modulation for realistic wow/flutter (~5 KB, kept off the hot lines)
     std::mt19937 rng;
     std::uniform_real_distribution<float> randomDist;
-    float wowRandomOffset = 0.0f;
-    float flutterRandomOffset = 0.0f;
 
-    // Delay line for wow/flutter pitch modulation
-    static const int MAX_DELAY_SAMPLES = 2048;  // ~46ms at 44.1kHz
-    std::vector<float> delayLineL;
-    std::vector<float> delayLineR;
-    int writeIndex = 0;
-    float baseDelayMs = 10.0f;  // Center delay for modulation
+    // Transfer curve display: one pair every scopeStride saturation samples
+    TransferScope transferScope;
+    int scopeStride = 1;
+    int scopePhase = 0;
 
-    // Noise generator for hiss
-    DSPUtils::NoiseGenerator noiseGen;
-    float hissFilterStateL = 0.0f;
-    float hissFilterStateR = 0.0f;
+#if TAPEWARM_PROFILING
+    StageProfiler profiler;
+#endif
 
-    // Level metering
+    // Level metering (written once per block, read by the editor)
     std::atomic<float> inputLevel { 0.0f };
     std::atomic<float> outputLevel { 0.0f };
 };
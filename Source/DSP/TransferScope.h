@@ -0,0 +1,55 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Decimated (input, output) pairs from the saturation stage for the
+// editor's XY display. The audio thread only publishes while the display
+// is open, and drops pairs rather than wait when the FIFO is full.
+class TransferScope
+{
+public:
+    struct Point
+    {
+        float input = 0.0f;
+        float output = 0.0f;
+    };
+
+    // Message thread: the display turns publishing on while it is visible
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive, std::memory_order_relaxed); }
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    // Audio thread
+    void push(const Point* points, int numPoints) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numPoints, start1, size1, start2, size2);
+        std::copy(points, points + size1, buffer + start1);
+        std::copy(points + size1, points + size1 + size2, buffer + start2);
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    // Message thread: drops the pairs left from the last time it was open
+    void clear() noexcept
+    {
+        fifo.finishedRead(fifo.getNumReady());
+    }
+
+    // Message thread; returns the number of points copied
+    int pull(Point* destination, int maxPoints) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxPoints, start1, size1, start2, size2);
+        std::copy(buffer + start1, buffer + start1 + size1, destination);
+        std::copy(buffer + start2, buffer + start2 + size2, destination + size1);
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    static constexpr int FIFO_SIZE = 4096;
+
+    std::atomic<bool> active { false };
+    juce::AbstractFifo fifo { FIFO_SIZE };
+    Point buffer[FIFO_SIZE];
+};
@@ -72,14 +72,10 @@ static void drawBrushedMetalTexture(juce::Graphics& g, juce::Rectangle<float> bo
     g.fillRoundedRectangle(bounds.getX(), bounds.getY(), bounds.getWidth(), 30.0f, 12.0f);
 }
 
-//==============================================================================
-// TapeWarmLookAndFeel implementation
-//==============================================================================
-void TapeWarmLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
-                                            float sliderPosProportional, float, float,
-                                            juce::Slider&)
+// Vector knob, used for the filmstrip frames and until they are ready
+static void drawKnob(juce::Graphics& g, juce::Rectangle<float> bounds, float sliderPosProportional)
 {
-    auto bounds = juce::Rectangle<float>((float)x, (float)y, (float)width, (float)height).reduced(4.0f);
+    bounds = bounds.reduced(4.0f);
     float cx = bounds.getCentreX();
     float cy = bounds.getCentreY();
     float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) / 2.0f - 2.0f;
@@ -136,6 +132,88 @@ void TapeWarmLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int
     g.fillEllipse(cx - 3, cy - 3, 6, 6);
 }
 
+//==============================================================================
+// KnobFilmstrips implementation
+//==============================================================================
+KnobFilmstrips::~KnobFilmstrips()
+{
+    pool.removeAllJobs(true, 2000);
+}
+
+juce::Image KnobFilmstrips::get(int size, float scale)
+{
+    const Key key { size, juce::roundToInt(scale * 100.0f) };
+
+    const juce::ScopedLock lock(stripsLock);
+
+    auto found = strips.find(key);
+    if (found != strips.end())
+        return found->second;  // Null until rendered
+
+    // First request for this size and scale: render in the background
+    strips.emplace(key, juce::Image());
+    pool.addJob([this, key]
+    {
+        auto strip = render(key.size, static_cast<float>(key.scale) / 100.0f);
+
+        {
+            const juce::ScopedLock renderedLock(stripsLock);
+            strips[key] = strip;
+        }
+
+        sendChangeMessage();
+    });
+
+    return {};
+}
+
+juce::Image KnobFilmstrips::render(int size, float scale)
+{
+    // Frames stacked vertically, one per slider position step
+    const int frameSize = juce::roundToInt(static_cast<float>(size) * scale);
+    juce::Image strip(juce::Image::ARGB, frameSize, frameSize * NUM_FRAMES, true, juce::SoftwareImageType());
+    juce::Graphics g(strip);
+
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        juce::Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(0, frame * frameSize, frameSize, frameSize);
+        g.addTransform(juce::AffineTransform::scale(scale).translated(0.0f, static_cast<float>(frame * frameSize)));
+
+        drawKnob(g, { static_cast<float>(size), static_cast<float>(size) },
+                 static_cast<float>(frame) / static_cast<float>(NUM_FRAMES - 1));
+    }
+
+    return strip;
+}
+
+//==============================================================================
+// TapeWarmLookAndFeel implementation
+//==============================================================================
+void TapeWarmLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+                                            float sliderPosProportional, float, float,
+                                            juce::Slider&)
+{
+    // Knobs are square, centred in the slider bounds
+    const int size = juce::jmin(width, height);
+    const int knobX = x + (width - size) / 2;
+    const int knobY = y + (height - size) / 2;
+
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto strip = filmstrips->get(size, scale);
+
+    if (! strip.isValid())
+    {
+        drawKnob(g, juce::Rectangle<int>(knobX, knobY, size, size).toFloat(), sliderPosProportional);
+        return;
+    }
+
+    // One blit of the nearest pre-rendered frame
+    const int frameSize = strip.getWidth();
+    const int frame = juce::roundToInt(juce::jlimit(0.0f, 1.0f, sliderPosProportional) * (KnobFilmstrips::NUM_FRAMES - 1));
+    g.drawImage(strip, knobX, knobY, size, size, 0, frame * frameSize, frameSize, frameSize);
+}
+
 //==============================================================================
 // VUMeter implementation
 //==============================================================================
@@ -232,6 +310,174 @@ void VUMeter::paint(juce::Graphics& g)
     g.drawRoundedRectangle(bounds, 4.0f, 1.0f);
 }
 
+#if TAPEWARM_PROFILING
+//==============================================================================
+// DiagnosticsPanel implementation
+//==============================================================================
+void DiagnosticsPanel::visibilityChanged()
+{
+    // Only poll the profiler while the panel is on screen
+    if (isVisible())
+        startTimerHz(4);
+    else
+        stopTimer();
+}
+
+void DiagnosticsPanel::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(juce::Colour(0xf0101010));
+    g.fillRoundedRectangle(bounds, 6.0f);
+    g.setColour(juce::Colour(0xff333333));
+    g.drawRoundedRectangle(bounds, 6.0f, 1.0f);
+
+    const int rowHeight = 16;
+    const int nameWidth = 110;
+    const int columnWidth = (getWidth() - nameWidth - 20) / 4;
+    int y = 8;
+
+    auto drawRow = [&](const juce::String& name, const juce::StringArray& columns)
+    {
+        g.drawText(name, 10, y, nameWidth, rowHeight, juce::Justification::centredLeft);
+        for (int i = 0; i < columns.size(); ++i)
+            g.drawText(columns[i], 10 + nameWidth + i * columnWidth, y, columnWidth, rowHeight, juce::Justification::centredRight);
+        y += rowHeight;
+    };
+
+    g.setFont(juce::FontOptions(11.0f).withStyle("Bold"));
+    g.setColour(TapeColors::gold);
+    drawRow("Stage (per block)", { "avg us", "p99 us", "max us", "budget" });
+
+    g.setFont(juce::FontOptions(11.0f));
+
+    for (int stage = 0; stage <= StageProfiler::Total; ++stage)
+    {
+        const auto summary = profiler.getSummary(stage);
+        g.setColour(stage == StageProfiler::Total ? TapeColors::gold : TapeColors::cream);
+        drawRow(StageProfiler::getStageName(stage),
+                { juce::String(summary.averageNs / 1000.0, 1),
+                  juce::String(summary.p99Ns / 1000.0, 1),
+                  juce::String(summary.maxNs / 1000.0, 1),
+                  juce::String(summary.budgetShare * 100.0, 2) + "%" });
+    }
+
+    g.setColour(TapeColors::cream.withAlpha(0.6f));
+    drawRow("Callback budget", { juce::String(profiler.getAverageBudgetNs() / 1000.0, 1) });
+
+    const auto footprint = processor.getMemoryFootprint();
+    drawRow("Memory", { juce::File::descriptionOfSizeInBytes(static_cast<juce::int64>(footprint.perInstance)),
+                        juce::File::descriptionOfSizeInBytes(static_cast<juce::int64>(footprint.shared)) + " shared" });
+}
+#endif
+
+//==============================================================================
+// LoudnessReadout implementation
+//==============================================================================
+void LoudnessReadout::setValues(const LoudnessMeter& meter)
+{
+    const float newMomentary = meter.getMomentary();
+    const float newShortTerm = meter.getShortTerm();
+    const float newIntegrated = meter.getIntegrated();
+    const float newTruePeak = meter.getTruePeak();
+
+    if (juce::exactlyEqual(newMomentary, momentary) && juce::exactlyEqual(newShortTerm, shortTerm)
+        && juce::exactlyEqual(newIntegrated, integrated) && juce::exactlyEqual(newTruePeak, truePeak))
+        return;
+
+    momentary = newMomentary;
+    shortTerm = newShortTerm;
+    integrated = newIntegrated;
+    truePeak = newTruePeak;
+    repaint();
+}
+
+void LoudnessReadout::paint(juce::Graphics& g)
+{
+    auto format = [](float value)
+    {
+        return value <= -70.0f ? juce::String("-inf") : juce::String(value, 1);
+    };
+
+    const auto text = "M " + format(momentary) + "  S " + format(shortTerm)
+                    + "  I " + format(integrated) + "  TP " + format(truePeak);
+
+    g.setColour(TapeColors::cream.withAlpha(0.8f));
+    g.setFont(juce::FontOptions(9.0f));
+    g.drawFittedText(text, getLocalBounds(), juce::Justification::centred, 1, 0.7f);
+}
+
+//==============================================================================
+// TransferScopeDisplay implementation
+//==============================================================================
+void TransferScopeDisplay::visibilityChanged()
+{
+    // Start from an empty trace rather than pairs from the last time it was open
+    if (isVisible())
+    {
+        scope.clear();
+        if (trace.isValid())
+            trace.clear(trace.getBounds());
+    }
+
+    scope.setActive(isVisible());
+}
+
+void TransferScopeDisplay::resized()
+{
+    trace = juce::Image(juce::Image::ARGB, juce::jmax(1, getWidth()), juce::jmax(1, getHeight()), true);
+}
+
+void TransferScopeDisplay::update()
+{
+    if (! isVisible() || ! trace.isValid())
+        return;
+
+    const int numPoints = scope.pull(points.data(), static_cast<int>(points.size()));
+
+    // Persistence: older pairs fade out over roughly half a second
+    trace.multiplyAllAlphas(0.85f);
+
+    juce::Graphics g(trace);
+    g.setColour(TapeColors::gold);
+
+    const float width = static_cast<float>(trace.getWidth());
+    const float height = static_cast<float>(trace.getHeight());
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const float x = juce::jmap(points[static_cast<size_t>(i)].input, -RANGE, RANGE, 0.0f, width);
+        const float y = juce::jmap(points[static_cast<size_t>(i)].output, -RANGE, RANGE, height, 0.0f);
+        g.fillRect(x - 0.75f, y - 0.75f, 1.5f, 1.5f);
+    }
+
+    repaint();
+}
+
+void TransferScopeDisplay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(juce::Colour(0xf0101010));
+    g.fillRoundedRectangle(bounds, 6.0f);
+
+    // Axes and the unity line
+    g.setColour(TapeColors::cream.withAlpha(0.15f));
+    g.drawHorizontalLine(getHeight() / 2, 0.0f, bounds.getWidth());
+    g.drawVerticalLine(getWidth() / 2, 0.0f, bounds.getHeight());
+    g.drawLine(0.0f, bounds.getHeight(), bounds.getWidth(), 0.0f, 1.0f);
+
+    g.drawImageAt(trace, 0, 0);
+
+    g.setColour(TapeColors::cream.withAlpha(0.6f));
+    g.setFont(juce::FontOptions(9.0f));
+    g.drawText("IN", getLocalBounds().reduced(6), juce::Justification::bottomRight);
+    g.drawText("OUT", getLocalBounds().reduced(6), juce::Justification::topLeft);
+
+    g.setColour(juce::Colour(0xff333333));
+    g.drawRoundedRectangle(bounds, 6.0f, 1.0f);
+}
+
 //==============================================================================
 // TapeReel implementation
 //==============================================================================
@@ -326,10 +572,14 @@ void TapeReel::paint(juce::Graphics& g)
 // TapeWarmAudioProcessorEditor implementation
 //==============================================================================
 TapeWarmAudioProcessorEditor::TapeWarmAudioProcessorEditor(TapeWarmAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), transferScopeDisplay(p.getTransferScope())
+#if TAPEWARM_PROFILING
+    , diagnosticsPanel(p)
+#endif
 {
     // Set the custom look and feel
     setLookAndFeel(&lookAndFeel);
+    lookAndFeel.getFilmstrips().addChangeListener(this);
 
     // Add tape reels
     addAndMakeVisible(leftReel);
@@ -339,6 +589,12 @@ TapeWarmAudioProcessorEditor::TapeWarmAudioProcessorEditor(TapeWarmAudioProcesso
     addAndMakeVisible(inputMeter);
     addAndMakeVisible(outputMeter);
 
+    // Loudness readouts (integrated loudness restarts on click)
+    inputLoudness.onClick = [this] { audioProcessor.resetLoudness(); };
+    outputLoudness.onClick = [this] { audioProcessor.resetLoudness(); };
+    addAndMakeVisible(inputLoudness);
+    addAndMakeVisible(outputLoudness);
+
     // Machine type selector
     machineTypeBox.addItem("7.5 IPS", 1);
     machineTypeBox.addItem("15 IPS", 2);
@@ -369,6 +625,47 @@ TapeWarmAudioProcessorEditor::TapeWarmAudioProcessorEditor(TapeWarmAudioProcesso
     tapeLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(tapeLabel);
 
+    // Quality selector
+    qualityBox.addItem("Eco", 1);
+    qualityBox.addItem("Standard", 2);
+    qualityBox.addItem("HQ", 3);
+    qualityBox.setColour(juce::ComboBox::backgroundColourId, TapeColors::faceplate);
+    qualityBox.setColour(juce::ComboBox::textColourId, TapeColors::cream);
+    qualityBox.setColour(juce::ComboBox::outlineColourId, TapeColors::gold.withAlpha(0.5f));
+    addAndMakeVisible(qualityBox);
+
+    qualityLabel.setText("QUALITY", juce::dontSendNotification);
+    qualityLabel.setColour(juce::Label::textColourId, TapeColors::cream);
+    qualityLabel.setFont(juce::FontOptions(10.0f).withStyle("Bold"));
+    qualityLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(qualityLabel);
+
+    // Anti-aliasing selector
+    aliasingBox.addItem("Oversampling", 1);
+    aliasingBox.addItem("ADAA 1st", 2);
+    aliasingBox.addItem("ADAA 2nd", 3);
+    aliasingBox.setColour(juce::ComboBox::backgroundColourId, TapeColors::faceplate);
+    aliasingBox.setColour(juce::ComboBox::textColourId, TapeColors::cream);
+    aliasingBox.setColour(juce::ComboBox::outlineColourId, TapeColors::gold.withAlpha(0.5f));
+    addAndMakeVisible(aliasingBox);
+
+    // Emphasis selector
+    emphasisBox.addItem("No Emphasis", 1);
+    emphasisBox.addItem("NAB", 2);
+    emphasisBox.addItem("IEC/CCIR", 3);
+    emphasisBox.setColour(juce::ComboBox::backgroundColourId, TapeColors::faceplate);
+    emphasisBox.setColour(juce::ComboBox::textColourId, TapeColors::cream);
+    emphasisBox.setColour(juce::ComboBox::outlineColourId, TapeColors::gold.withAlpha(0.5f));
+    addAndMakeVisible(emphasisBox);
+
+    // Machine response selector
+    responseBox.addItem("Filters", 1);
+    responseBox.addItem("Convolution", 2);
+    responseBox.setColour(juce::ComboBox::backgroundColourId, TapeColors::faceplate);
+    responseBox.setColour(juce::ComboBox::textColourId, TapeColors::cream);
+    responseBox.setColour(juce::ComboBox::outlineColourId, TapeColors::gold.withAlpha(0.5f));
+    addAndMakeVisible(responseBox);
+
     // Setup main knobs - Row 1
     setupKnob(inputDriveKnob, inputDriveLabel, "INPUT");
     setupKnob(saturationKnob, saturationLabel, "SATURATION");
@@ -404,19 +701,49 @@ TapeWarmAudioProcessorEditor::TapeWarmAudioProcessorEditor(TapeWarmAudioProcesso
     biasAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "bias", biasSlider);
     machineTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "machineType", machineTypeBox);
     tapeTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "tapeType", tapeTypeBox);
-
-    // Load background image
+    qualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "quality", qualityBox);
+    aliasingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "aliasing", aliasingBox);
+    responseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "response", responseBox);
+    emphasisAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "emphasis", emphasisBox);
+
+    // Transfer curve display over the main knobs, hidden until toggled
+    scopeButton.setClickingTogglesState(true);
+    scopeButton.setColour(juce::TextButton::buttonColourId, TapeColors::knobBody);
+    scopeButton.setColour(juce::TextButton::buttonOnColourId, TapeColors::gold.darker(0.3f));
+    scopeButton.setColour(juce::TextButton::textColourOffId, TapeColors::cream);
+    scopeButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    scopeButton.onClick = [this] { transferScopeDisplay.setVisible(scopeButton.getToggleState()); };
+    addAndMakeVisible(scopeButton);
+    addChildComponent(transferScopeDisplay);
+
+#if TAPEWARM_PROFILING
+    // Hidden until Alt+click; added last so it sits above the controls
+    addChildComponent(diagnosticsPanel);
+#endif
+
+    // Load background image; ImageCache keeps the decoded copy, so editors
+    // opened after the first one skip the PNG decode
     juce::File imageFile("/Users/ianfletcher/tapewarm/Source/background.png");
     if (imageFile.existsAsFile())
-        backgroundImage = juce::ImageFileFormat::loadFrom(imageFile);
+        backgroundImage = juce::ImageCache::getFromFile(imageFile);
 
     setSize(600, 540);
     startTimerHz(30);
 }
 
+#if TAPEWARM_PROFILING
+void TapeWarmAudioProcessorEditor::mouseDown(const juce::MouseEvent& event)
+{
+    // Alt+click on the faceplate toggles the diagnostics panel
+    if (event.mods.isAltDown())
+        diagnosticsPanel.setVisible(! diagnosticsPanel.isVisible());
+}
+#endif
+
 TapeWarmAudioProcessorEditor::~TapeWarmAudioProcessorEditor()
 {
     stopTimer();
+    lookAndFeel.getFilmstrips().removeChangeListener(this);
     setLookAndFeel(nullptr);
 }
 
@@ -462,6 +789,11 @@ void TapeWarmAudioProcessorEditor::timerCallback()
 
     inputMeter.setLevel(smoothedInputLevel);
     outputMeter.setLevel(smoothedOutputLevel);
+
+    inputLoudness.setValues(audioProcessor.getInputLoudness());
+    outputLoudness.setValues(audioProcessor.getOutputLoudness());
+
+    transferScopeDisplay.update();
 }
 
 void TapeWarmAudioProcessorEditor::paint(juce::Graphics& g)
@@ -569,17 +901,24 @@ void TapeWarmAudioProcessorEditor::resized()
 
     // VU Meters between reels - SIGNIFICANTLY LARGER
     int meterWidth = 160;
-    int meterHeight = 32;
+    int meterHeight = 24;     // Leaves room for the loudness readouts
     inputMeter.setBounds(130, 78, meterWidth, meterHeight);
     outputMeter.setBounds(310, 78, meterWidth, meterHeight);
 
-    // Type selectors
-    int selectorWidth = 130;
-    machineLabel.setBounds(145, 118, selectorWidth, 14);
-    machineTypeBox.setBounds(145, 133, selectorWidth, 24);
+    // Loudness readouts under the meters
+    inputLoudness.setBounds(130, 78 + meterHeight + 2, meterWidth, 12);
+    outputLoudness.setBounds(310, 78 + meterHeight + 2, meterWidth, 12);
+
+    // Type and quality selectors
+    int selectorWidth = 115;
+    machineLabel.setBounds(117, 118, selectorWidth, 14);
+    machineTypeBox.setBounds(117, 133, selectorWidth, 24);
 
-    tapeLabel.setBounds(310, 118, selectorWidth, 14);
-    tapeTypeBox.setBounds(310, 133, selectorWidth, 24);
+    tapeLabel.setBounds(242, 118, selectorWidth, 14);
+    tapeTypeBox.setBounds(242, 133, selectorWidth, 24);
+
+    qualityLabel.setBounds(367, 118, selectorWidth, 14);
+    qualityBox.setBounds(367, 133, selectorWidth, 24);
 
     // Main knobs - Row 1 (larger knobs)
     int knobSize = 75;
@@ -631,4 +970,18 @@ void TapeWarmAudioProcessorEditor::resized()
 
     bumpFreqLabel.setBounds(secStartX + secKnobSpacing * 3, secKnobY, secKnobSize, 14);
     bumpFreqSlider.setBounds(secStartX + secKnobSpacing * 3, secKnobY + 14, secKnobSize, secKnobSize);
+
+    // Anti-aliasing and emphasis selectors (top left), response selector
+    // and XY display toggle (top right), above the reels, and the XY
+    // display itself
+    aliasingBox.setBounds(46, 28, 100, 18);
+    emphasisBox.setBounds(46, 50, 100, 18);
+    responseBox.setBounds(getWidth() - 194, 28, 96, 18);
+    scopeButton.setBounds(getWidth() - 90, 28, 44, 18);
+    transferScopeDisplay.setBounds(202, 168, 196, 196);
+
+#if TAPEWARM_PROFILING
+    // Over the main knobs
+    diagnosticsPanel.setBounds(60, 168, getWidth() - 120, 212);
+#endif
 }
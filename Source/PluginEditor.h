@@ -2,6 +2,39 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include <map>
+
+//==============================================================================
+// Pre-rendered knob images, one vertical filmstrip of NUM_FRAMES angles per
+// knob size and display scale, shared by every editor in the process.
+// Strips render on a background thread; get() returns a null image until
+// then and a change message is sent when one is ready.
+//==============================================================================
+class KnobFilmstrips : public juce::ChangeBroadcaster
+{
+public:
+    static constexpr int NUM_FRAMES = 101;
+
+    ~KnobFilmstrips() override;
+
+    // Message thread; size in logical pixels
+    juce::Image get(int size, float scale);
+
+private:
+    struct Key
+    {
+        int size;
+        int scale;      // Percent
+
+        bool operator<(const Key& other) const { return size != other.size ? size < other.size : scale < other.scale; }
+    };
+
+    static juce::Image render(int size, float scale);
+
+    juce::CriticalSection stripsLock;
+    std::map<Key, juce::Image> strips;
+    juce::ThreadPool pool { 1 };
+};
 
 //==============================================================================
 // Custom LookAndFeel for vintage tape machine style knobs
@@ -14,6 +47,11 @@ public:
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                           float sliderPosProportional, float, float,
                           juce::Slider&) override;
+
+    KnobFilmstrips& getFilmstrips() { return *filmstrips; }
+
+private:
+    juce::SharedResourcePointer<KnobFilmstrips> filmstrips;
 };
 
 //==============================================================================
@@ -31,6 +69,50 @@ private:
     int peakHoldCounter = 0;
 };
 
+//==============================================================================
+// Loudness readout under a VU meter (click to restart integration)
+//==============================================================================
+class LoudnessReadout : public juce::Component
+{
+public:
+    void setValues(const LoudnessMeter& meter);
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent&) override { if (onClick) onClick(); }
+
+    std::function<void()> onClick;
+
+private:
+    float momentary = LoudnessMeter::SILENCE;
+    float shortTerm = LoudnessMeter::SILENCE;
+    float integrated = LoudnessMeter::SILENCE;
+    float truePeak = LoudnessMeter::SILENCE;
+};
+
+//==============================================================================
+// XY display of the saturation transfer curve with persistence; the audio
+// thread only publishes pairs while this is visible
+//==============================================================================
+class TransferScopeDisplay : public juce::Component
+{
+public:
+    explicit TransferScopeDisplay(TransferScope& scopeToShow) : scope(scopeToShow) {}
+    ~TransferScopeDisplay() override { scope.setActive(false); }
+
+    // Called from the editor timer: fades the trace and plots new pairs
+    void update();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    static constexpr float RANGE = 1.5f;    // Axis extent, both directions
+
+    TransferScope& scope;
+    juce::Image trace;
+    std::vector<TransferScope::Point> points = std::vector<TransferScope::Point>(4096);
+};
+
 //==============================================================================
 // Tape reel animation component
 //==============================================================================
@@ -50,11 +132,33 @@ private:
     bool spinning = true;
 };
 
+#if TAPEWARM_PROFILING
+//==============================================================================
+// Diagnostics panel: per-stage DSP timings (profiling builds, Alt+click to show)
+//==============================================================================
+class DiagnosticsPanel : public juce::Component, public juce::Timer
+{
+public:
+    explicit DiagnosticsPanel(const TapeWarmAudioProcessor& processorToShow)
+        : processor(processorToShow), profiler(processorToShow.getProfiler()) {}
+    ~DiagnosticsPanel() override { stopTimer(); }
+
+    void paint(juce::Graphics& g) override;
+    void timerCallback() override { repaint(); }
+    void visibilityChanged() override;
+
+private:
+    const TapeWarmAudioProcessor& processor;
+    const StageProfiler& profiler;
+};
+#endif
+
 //==============================================================================
 // Main editor class
 //==============================================================================
 class TapeWarmAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                      public juce::Timer
+                                      public juce::Timer,
+                                      private juce::ChangeListener
 {
 public:
     TapeWarmAudioProcessorEditor(TapeWarmAudioProcessor&);
@@ -64,6 +168,13 @@ public:
     void resized() override;
     void timerCallback() override;
 
+    // Knob filmstrips finished rendering
+    void changeListenerCallback(juce::ChangeBroadcaster*) override { repaint(); }
+
+#if TAPEWARM_PROFILING
+    void mouseDown(const juce::MouseEvent& event) override;
+#endif
+
 private:
     TapeWarmAudioProcessor& audioProcessor;
 
@@ -78,13 +189,25 @@ private:
 
     // VU Meters
     VUMeter inputMeter, outputMeter;
+    LoudnessReadout inputLoudness, outputLoudness;
     float smoothedInputLevel = 0.0f;
     float smoothedOutputLevel = 0.0f;
 
+    // Transfer curve display, toggled by the XY button
+    juce::TextButton scopeButton { "XY" };
+    TransferScopeDisplay transferScopeDisplay;
+
     // Machine and tape type selectors
     juce::ComboBox machineTypeBox;
     juce::ComboBox tapeTypeBox;
-    juce::Label machineLabel, tapeLabel;
+    juce::ComboBox qualityBox;
+    juce::Label machineLabel, tapeLabel, qualityLabel;
+
+    // Anti-aliasing selector and emphasis standard (top left), machine
+    // response engine (top right)
+    juce::ComboBox aliasingBox;
+    juce::ComboBox emphasisBox;
+    juce::ComboBox responseBox;
 
     // Main knobs - Row 1
     juce::Slider inputDriveKnob;
@@ -121,6 +244,10 @@ private:
     juce::Label mixLabel;
     juce::Label biasLabel;
 
+#if TAPEWARM_PROFILING
+    DiagnosticsPanel diagnosticsPanel;
+#endif
+
     // Parameter attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> inputDriveAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> saturationAttachment;
@@ -136,6 +263,10 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> biasAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> machineTypeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> tapeTypeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> qualityAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> aliasingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> responseAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> emphasisAttachment;
 
     void setupKnob(juce::Slider& slider, juce::Label& label, const juce::String& text);
     void setupSecondarySlider(juce::Slider& slider, juce::Label& label, const juce::String& text);
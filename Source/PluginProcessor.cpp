@@ -1,11 +1,13 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "DSP/RealtimeChecker.h"
 
 TapeWarmAudioProcessor::TapeWarmAudioProcessor()
      : AudioProcessor (BusesProperties()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
-       apvts(*this, nullptr, "Parameters", createParameterLayout())
+       apvts(*this, nullptr, "Parameters", createParameterLayout()),
+       traceRecorder(getParameters())
 {
     // Get parameter pointers
     inputDrive = apvts.getRawParameterValue("inputDrive");
@@ -22,9 +24,20 @@ TapeWarmAudioProcessor::TapeWarmAudioProcessor()
     bias = apvts.getRawParameterValue("bias");
     machineType = apvts.getRawParameterValue("machineType");
     tapeType = apvts.getRawParameterValue("tapeType");
+    quality = apvts.getRawParameterValue("quality");
+    aliasing = apvts.getRawParameterValue("aliasing");
+    response = apvts.getRawParameterValue("response");
+    emphasis = apvts.getRawParameterValue("emphasis");
+    bypass = apvts.getRawParameterValue("bypass");
+    bypassParameter = apvts.getParameter("bypass");
+
+    startTimerHz(10);
 }
 
-TapeWarmAudioProcessor::~TapeWarmAudioProcessor() {}
+TapeWarmAudioProcessor::~TapeWarmAudioProcessor()
+{
+    stopTimer();
+}
 
 juce::AudioProcessorValueTreeState::ParameterLayout TapeWarmAudioProcessor::createParameterLayout()
 {
@@ -107,11 +120,39 @@ juce::AudioProcessorValueTreeState::ParameterLayout TapeWarmAudioProcessor::crea
         juce::ParameterID("machineType", 1), "Machine",
         juce::StringArray{ "7.5 IPS", "15 IPS", "30 IPS" }, 1));
 
+    // Response: the machine's head bump as a biquad, or its full measured
+    // (or modelled) impulse response by convolution
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("response", 1), "Response",
+        juce::StringArray{ "Filters", "Convolution" }, 0));
+
+    // Emphasis: record pre-emphasis before the saturation and playback
+    // de-emphasis after it, per standard at the machine's speed
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("emphasis", 1), "Emphasis",
+        juce::StringArray{ "Off", "NAB", "IEC/CCIR" }, 0));
+
     // Tape Type: Type I, Type II, Modern
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID("tapeType", 1), "Tape",
         juce::StringArray{ "Type I (Ferric)", "Type II (Chrome)", "Modern" }, 0));
 
+    // Quality: Eco, Standard, HQ (offline renders always use HQ)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("quality", 1), "Quality",
+        juce::StringArray{ "Eco", "Standard", "HQ" }, 1));
+
+    // Aliasing: the quality tier's oversampling, or first/second-order ADAA
+    // at 1x for the Type II and Modern curves (cheaper for large sessions)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("aliasing", 1), "Aliasing",
+        juce::StringArray{ "Oversampling", "ADAA 1st", "ADAA 2nd" }, 0));
+
+    // Bypass: 20ms crossfade to the latency-aligned dry signal, after which
+    // the tape chain stops running
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("bypass", 1), "Bypass", false));
+
     return { params.begin(), params.end() };
 }
 
@@ -128,14 +169,100 @@ void TapeWarmAudioProcessor::changeProgramName(int index, const juce::String& ne
 
 void TapeWarmAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    preparedQuality = getEffectiveQuality();
+    preparedAntialiasing = getEffectiveAntialiasing();
+    tapeProcessor.setQuality(preparedQuality);
+    tapeProcessor.setAntialiasing(preparedAntialiasing);
     tapeProcessor.prepare(sampleRate, samplesPerBlock);
+    updateLatency();
+
+    inputLoudness.prepare(sampleRate, getTotalNumInputChannels());
+    outputLoudness.prepare(sampleRate, getTotalNumOutputChannels());
+
+    const auto footprint = tapeProcessor.getMemoryFootprint();
+    memoryPerInstance.store(footprint.perInstance);
+    memoryShared.store(footprint.shared);
 }
 
 void TapeWarmAudioProcessor::releaseResources()
 {
+    preparedQuality = preparedAntialiasing = -1;
     tapeProcessor.reset();
 }
 
+void TapeWarmAudioProcessor::timerCallback()
+{
+    // Nothing to re-prepare until the host has prepared us. A bounce got its
+    // tier in setNonRealtime(), and must not be suspended or reset midway
+    if (preparedQuality < 0 || isNonRealtime())
+        return;
+
+    if (getEffectiveQuality() == preparedQuality && getEffectiveAntialiasing() == preparedAntialiasing)
+    {
+        updateLatency();
+        return;
+    }
+
+    // The chain restarts from silence, as when the host itself re-prepares.
+    // The callback lock keeps processBlock out, and keeps this from racing a
+    // switch to offline made on the audio thread
+    RealtimeChecker::checkBlockingCall("callback lock");
+    const juce::ScopedLock lock(getCallbackLock());
+    applyEffectiveTier();
+}
+
+void TapeWarmAudioProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime(isNonRealtime);
+
+    // Hosts switch between blocks, and some without re-preparing, so the
+    // tier is applied now rather than by the timer once the bounce has
+    // started. The callback lock keeps processBlock out meanwhile
+    RealtimeChecker::checkBlockingCall("callback lock");
+    const juce::ScopedLock lock(getCallbackLock());
+    applyEffectiveTier();
+}
+
+void TapeWarmAudioProcessor::applyEffectiveTier()
+{
+    const int newQuality = getEffectiveQuality();
+    const int newAntialiasing = getEffectiveAntialiasing();
+
+    if (preparedQuality < 0 || (newQuality == preparedQuality && newAntialiasing == preparedAntialiasing))
+        return;
+
+    preparedQuality = newQuality;
+    preparedAntialiasing = newAntialiasing;
+    tapeProcessor.setQuality(newQuality);
+    tapeProcessor.setAntialiasing(newAntialiasing);
+    tapeProcessor.prepare(getSampleRate(), getBlockSize());
+    updateLatency();
+}
+
+int TapeWarmAudioProcessor::getEffectiveQuality() const
+{
+    // Bounces always get the best quality, whatever the tracking setting
+    if (isNonRealtime())
+        return static_cast<int>(QualityMode::HQ);
+
+    return static_cast<int>(quality->load());
+}
+
+int TapeWarmAudioProcessor::getEffectiveAntialiasing() const
+{
+    if (isNonRealtime())
+        return static_cast<int>(AntialiasingMode::Oversampling);
+
+    return static_cast<int>(aliasing->load());
+}
+
+void TapeWarmAudioProcessor::updateLatency()
+{
+    // Latency depends on the quality tier and anti-aliasing mode
+    if (tapeProcessor.getLatencySamples() != getLatencySamples())
+        setLatencySamples(tapeProcessor.getLatencySamples());
+}
+
 bool TapeWarmAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
     if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
@@ -150,6 +277,9 @@ void TapeWarmAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
 {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    RealtimeChecker::ScopedRealtime realtimeScope;
+
+    traceRecorder.beginBlock();
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -170,26 +300,173 @@ void TapeWarmAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
     tapeProcessor.setAge(age->load());
     tapeProcessor.setBias(bias->load());
     tapeProcessor.setMachineType(static_cast<int>(machineType->load()));
+    tapeProcessor.setResponseMode(static_cast<int>(response->load()));
+    tapeProcessor.setEmphasis(static_cast<int>(emphasis->load()));
     tapeProcessor.setTapeType(static_cast<int>(tapeType->load()));
+    tapeProcessor.setBypassed(bypass->load() > 0.5f);
 
     // Process audio
+    inputLoudness.push(buffer);
     tapeProcessor.process(buffer);
+    outputLoudness.push(buffer);
+
+    traceRecorder.endBlock(buffer.getNumSamples(), tapeProcessor.getActiveStages());
+}
+
+void TapeWarmAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+    RealtimeChecker::ScopedRealtime realtimeScope;
+
+    // Hosts that bypass without the parameter get the same crossfade and
+    // aligned dry path; the next processBlock fades back in
+    traceRecorder.beginBlock();
+    tapeProcessor.setBypassed(true);
+    tapeProcessor.process(buffer);
+    traceRecorder.endBlock(buffer.getNumSamples(), tapeProcessor.getActiveStages());
 }
 
+// Children of the APVTS state that hold parameter values
+static const juce::Identifier parameterTreeType { "PARAM" };
+
 void TapeWarmAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Compact binary state: header, then (ID, value) for every parameter,
+    // written straight from the parameters
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(static_cast<int>(stateMagic));
+    stream.writeInt(stateVersion);
+
+    const auto& parameters = getParameters();
+    stream.writeInt(parameters.size());
+
+    for (auto* parameter : parameters)
+    {
+        auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+        const auto& id = ranged->getParameterID();
+
+        stream.writeByte(static_cast<char>(id.getNumBytesAsUTF8()));
+        stream.write(id.toRawUTF8(), id.getNumBytesAsUTF8());
+        stream.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    // Then the rest of the state tree (its properties and non-parameter
+    // children) as a size-prefixed ValueTree, empty when there is none
+    juce::ValueTree extra(apvts.state.getType());
+    const auto state = apvts.copyState();
+    extra.copyPropertiesFrom(state, nullptr);
+
+    for (const auto& child : state)
+        if (! child.hasType(parameterTreeType))
+            extra.appendChild(child.createCopy(), nullptr);
+
+    juce::MemoryOutputStream extraStream;
+    if (extra.getNumProperties() > 0 || extra.getNumChildren() > 0)
+        extra.writeToStream(extraStream);
+
+    stream.writeInt(static_cast<int>(extraStream.getDataSize()));
+    stream.write(extraStream.getData(), extraStream.getDataSize());
 }
 
 void TapeWarmAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (readBinaryState(data, sizeInBytes))
+        return;
+
+    // Legacy sessions: APVTS state saved as XML
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
         apvts.replaceState(juce::ValueTree::fromXml(*xml));
 }
 
+bool TapeWarmAudioProcessor::readBinaryState(const void* data, int sizeInBytes)
+{
+    juce::MemoryInputStream stream(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), false);
+
+    if (sizeInBytes < 12 || static_cast<juce::uint32>(stream.readInt()) != stateMagic)
+        return false;
+
+    // Newer versions may change the layout; keep the current state
+    const int version = stream.readInt();
+    if (version < 1 || version > stateVersion)
+        return true;
+
+    // Parse and check everything before applying any of it, so a truncated
+    // stream cannot leave some parameters loaded and others read as zero
+    const int numParameters = stream.readInt();
+    if (numParameters < 0 || numParameters > maxStateParameters)
+        return true;
+
+    std::vector<std::pair<juce::String, float>> values;
+    values.reserve(static_cast<size_t>(numParameters));
+    char id[256];
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        if (stream.getNumBytesRemaining() < 1)
+            return true;
+
+        const int idLength = static_cast<juce::uint8>(stream.readByte());
+        if (stream.getNumBytesRemaining() < idLength + static_cast<int>(sizeof(float)))
+            return true;
+
+        stream.read(id, idLength);
+        values.emplace_back(juce::String::fromUTF8(id, idLength), stream.readFloat());
+    }
+
+    juce::ValueTree extra;
+
+    if (version >= 2)
+    {
+        if (stream.getNumBytesRemaining() < 4)
+            return true;
+
+        const int extraSize = stream.readInt();
+        if (extraSize < 0 || extraSize > stream.getNumBytesRemaining())
+            return true;
+
+        if (extraSize > 0)
+        {
+            extra = juce::ValueTree::readFromData(static_cast<const char*>(data) + stream.getPosition(),
+                                                  static_cast<size_t>(extraSize));
+            if (! extra.isValid())
+                return true;
+        }
+    }
+
+    // Unknown IDs (parameters removed since the session was saved) are
+    // skipped; parameters the session predates go back to their defaults
+    for (auto* parameter : getParameters())
+    {
+        auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+        const auto saved = std::find_if(values.begin(), values.end(), [ranged](const auto& entry)
+        {
+            return entry.first == ranged->getParameterID();
+        });
+
+        ranged->setValueNotifyingHost(saved != values.end() ? ranged->convertTo0to1(saved->second)
+                                                            : ranged->getDefaultValue());
+    }
+
+    // Version 2 also replaces the rest of the tree (an invalid extra tree
+    // clears it); version 1 sessions carry none, so it is left as it is
+    if (version >= 2)
+    {
+        auto& state = apvts.state;
+        state.copyPropertiesFrom(extra, nullptr);
+
+        for (int i = state.getNumChildren(); --i >= 0;)
+            if (! state.getChild(i).hasType(parameterTreeType))
+                state.removeChild(i, nullptr);
+
+        for (const auto& child : extra)
+            state.appendChild(child.createCopy(), nullptr);
+    }
+
+    return true;
+}
+
 juce::AudioProcessorEditor* TapeWarmAudioProcessor::createEditor()
 {
     return new TapeWarmAudioProcessorEditor(*this);
@@ -2,8 +2,11 @@
 
 #include <JuceHeader.h>
 #include "DSP/TapeProcessor.h"
+#include "DSP/LoudnessMeter.h"
+#include "TraceRecorder.h"
 
-class TapeWarmAudioProcessor : public juce::AudioProcessor
+class TapeWarmAudioProcessor : public juce::AudioProcessor,
+                               private juce::Timer
 {
 public:
     TapeWarmAudioProcessor();
@@ -15,8 +18,17 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     using AudioProcessor::processBlock;
 
+    // Switches to the offline tier (or back) before the next block, as some
+    // hosts start a bounce without re-preparing
+    void setNonRealtime (bool isNonRealtime) noexcept override;
+
+    // Hosts drive this instead of bypassing around the plugin, so bypass
+    // crossfades and stays latency aligned
+    juce::AudioProcessorParameter* getBypassParameter() const override { return bypassParameter; }
+
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
 
@@ -36,19 +48,75 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    // Binary state format ("TWST"); older sessions stored APVTS XML.
+    // Version 2 adds the non-parameter part of the state tree
+    static constexpr juce::uint32 stateMagic = 0x54535754;
+    static constexpr int stateVersion = 2;
+
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
 
     // Level metering
     float getInputLevel() const { return tapeProcessor.getInputLevel(); }
     float getOutputLevel() const { return tapeProcessor.getOutputLevel(); }
 
+    // Loudness before and after the tape chain
+    const LoudnessMeter& getInputLoudness() const { return inputLoudness; }
+    const LoudnessMeter& getOutputLoudness() const { return outputLoudness; }
+    void resetLoudness() { inputLoudness.reset(); outputLoudness.reset(); }
+
+    // Saturation input/output pairs for the XY display
+    TransferScope& getTransferScope() { return tapeProcessor.getTransferScope(); }
+
+    // Memory held by this instance, and shared with other instances, as of
+    // the last prepareToPlay (readable from any thread)
+    TapeProcessor::MemoryFootprint getMemoryFootprint() const { return { memoryPerInstance.load(), memoryShared.load() }; }
+
+#if TAPEWARM_PROFILING
+    const StageProfiler& getProfiler() const { return tapeProcessor.getProfiler(); }
+#endif
+
 private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    static constexpr int maxStateParameters = 1024;
+
+    // Returns false if the data is not in the binary format. Binary data
+    // that is truncated or malformed is rejected as a whole, keeping the
+    // current state
+    bool readBinaryState(const void* data, int sizeInBytes);
+
+    // Quality tier to run; offline renders are forced to HQ
+    int getEffectiveQuality() const;
+
+    // Anti-aliasing to run; offline renders are forced to oversampling
+    int getEffectiveAntialiasing() const;
+    void updateLatency();
+
+    // Quality tier and anti-aliasing changes alter the latency, so they are
+    // picked up here, on the message thread, and applied by re-preparing the
+    // processor under the callback lock. Skipped while rendering offline
+    void timerCallback() override;
+
+    // Re-prepares the processor if the effective tier differs from the
+    // prepared one; the caller holds the callback lock
+    void applyEffectiveTier();
+    int preparedQuality = -1;           // -1 until prepareToPlay
+    int preparedAntialiasing = -1;
+
     // DSP
     TapeProcessor tapeProcessor;
 
+    // Analysis runs on a shared background thread; processBlock only copies samples
+    LoudnessMeter inputLoudness, outputLoudness;
+
+    // Per-block timing trace, when TAPEWARM_TRACE is set
+    TraceRecorder traceRecorder;
+
+    // Memory footprint, measured in prepareToPlay
+    std::atomic<size_t> memoryPerInstance { 0 };
+    std::atomic<size_t> memoryShared { 0 };
+
     // Parameter pointers for fast access
     std::atomic<float>* inputDrive = nullptr;
     std::atomic<float>* saturation = nullptr;
@@ -64,6 +132,12 @@ private:
     std::atomic<float>* bias = nullptr;
     std::atomic<float>* machineType = nullptr;
     std::atomic<float>* tapeType = nullptr;
+    std::atomic<float>* quality = nullptr;
+    std::atomic<float>* aliasing = nullptr;
+    std::atomic<float>* response = nullptr;
+    std::atomic<float>* emphasis = nullptr;
+    std::atomic<float>* bypass = nullptr;
+    juce::AudioProcessorParameter* bypassParameter = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TapeWarmAudioProcessor)
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+// Stands in for the Projucer's JuceHeader.h when the DSP sources are built
+// into the Python module: only the modules they use, none of the GUI or
+// plugin client ones
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
@@ -0,0 +1,290 @@
+#include <JuceHeader.h>
+#include "../DSP/OfflineRenderer.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace
+{
+    // Setters by the name used for both the methods (set_<name>) and the
+    // process_batch() settings keys
+    struct FloatParameter
+    {
+        const char* name;
+        void (TapeProcessor::*set)(float);
+        const char* range;
+    };
+
+    struct ChoiceParameter
+    {
+        const char* name;
+        void (TapeProcessor::*set)(int);
+        const char* range;
+    };
+
+    const FloatParameter floatParameters[] = {
+        { "input_drive", &TapeProcessor::setInputDrive, "-12 to +12 dB" },
+        { "saturation",  &TapeProcessor::setSaturation, "0-100%" },
+        { "warmth",      &TapeProcessor::setWarmth,     "0-100%" },
+        { "head_bump",   &TapeProcessor::setHeadBump,   "0-100%" },
+        { "bump_freq",   &TapeProcessor::setBumpFreq,   "40-150 Hz" },
+        { "wow",         &TapeProcessor::setWow,        "0-100%" },
+        { "flutter",     &TapeProcessor::setFlutter,    "0-100%" },
+        { "hiss",        &TapeProcessor::setHiss,       "0-100%" },
+        { "output",      &TapeProcessor::setOutput,     "-12 to +12 dB" },
+        { "mix",         &TapeProcessor::setMix,        "0-100%" },
+        { "age",         &TapeProcessor::setAge,        "0-100%" },
+        { "bias",        &TapeProcessor::setBias,       "0-100%" }
+    };
+
+    const ChoiceParameter choiceParameters[] = {
+        { "machine_type",  &TapeProcessor::setMachineType,  "MachineType" },
+        { "tape_type",     &TapeProcessor::setTapeType,     "TapeType" },
+        { "quality",       &TapeProcessor::setQuality,      "QualityMode, applied by the next prepare()" },
+        { "antialiasing",  &TapeProcessor::setAntialiasing, "AntialiasingMode, applied by the next prepare()" },
+        { "response_mode", &TapeProcessor::setResponseMode, "ResponseMode" },
+        { "emphasis",      &TapeProcessor::setEmphasis,     "EmphasisMode" }
+    };
+
+    // Enum members and plain ints both convert through __int__
+    int toChoice(const py::handle& value)
+    {
+        return py::int_(py::reinterpret_borrow<py::object>(value)).cast<int>();
+    }
+
+    // The processor and its Python-side state. Python threads may share an
+    // instance, and process() runs without the GIL, so calls are serialised
+    struct PythonProcessor
+    {
+        TapeProcessor processor;
+        std::mutex lock;
+        bool prepared = false;
+        bool timeline = false;
+    };
+
+    // Refers to a float32 array of shape (samples,) or (channels, samples)
+    // without copying; anything else is rejected rather than converted, as
+    // the processing is in place
+    OfflineRenderer::Clip viewOf(const py::handle& audio)
+    {
+        if (! py::isinstance<py::array_t<float>>(audio))
+            throw py::type_error("audio must be a float32 NumPy array");
+
+        auto array = py::reinterpret_borrow<py::array>(audio);
+        if (! array.writeable())
+            throw py::value_error("audio must be writeable (it is processed in place)");
+        if (array.ndim() < 1 || array.ndim() > 2)
+            throw py::value_error("audio must have shape (samples,) or (channels, samples)");
+
+        const auto numChannels = array.ndim() == 2 ? array.shape(0) : 1;
+        const auto numSamples = array.shape(array.ndim() - 1);
+        if (numChannels < 1 || numChannels > 2)
+            throw py::value_error("audio must have one or two channels");
+        if (numSamples > std::numeric_limits<int>::max())
+            throw py::value_error("audio is too long");
+        if (numSamples > 1 && array.strides(array.ndim() - 1) != static_cast<py::ssize_t>(sizeof(float)))
+            throw py::value_error("audio samples must be contiguous");
+
+        auto* data = static_cast<char*>(array.mutable_data());
+        const auto channelStride = array.ndim() == 2 ? array.strides(0) : 0;
+
+        OfflineRenderer::Clip clip { { nullptr, nullptr }, static_cast<int>(numChannels), static_cast<int>(numSamples) };
+        for (int ch = 0; ch < clip.numChannels; ++ch)
+            clip.channels[ch] = reinterpret_cast<float*>(data + ch * channelStride);
+
+        return clip;
+    }
+
+    // Settings are parsed here, with the GIL held, into plain values the
+    // worker threads can apply without it
+    OfflineRenderer::Configure parseSettings(const py::dict& settings)
+    {
+        std::vector<std::function<void(TapeProcessor&)>> setters;
+
+        for (const auto& [key, value] : settings)
+        {
+            const auto name = key.cast<std::string>();
+            const auto matches = [&name](const auto& parameter) { return name == parameter.name; };
+
+            if (auto f = std::find_if(std::begin(floatParameters), std::end(floatParameters), matches);
+                f != std::end(floatParameters))
+            {
+                setters.push_back([set = f->set, v = value.cast<float>()](TapeProcessor& p) { (p.*set)(v); });
+            }
+            else if (auto c = std::find_if(std::begin(choiceParameters), std::end(choiceParameters), matches);
+                     c != std::end(choiceParameters))
+            {
+                setters.push_back([set = c->set, v = toChoice(value)](TapeProcessor& p) { (p.*set)(v); });
+            }
+            else
+            {
+                throw py::key_error("unknown setting '" + name + "'");
+            }
+        }
+
+        return [setters = std::move(setters)](TapeProcessor& processor)
+        {
+            for (const auto& set : setters)
+                set(processor);
+        };
+    }
+}
+
+PYBIND11_MODULE(tapewarm, m)
+{
+    m.doc() = "TapeWarm tape chain, processing float32 NumPy arrays in place";
+
+    py::enum_<MachineType>(m, "MachineType")
+        .value("IPS_7_5", MachineType::IPS_7_5)
+        .value("IPS_15", MachineType::IPS_15)
+        .value("IPS_30", MachineType::IPS_30);
+
+    py::enum_<TapeType>(m, "TapeType")
+        .value("TYPE_I", TapeType::TypeI)
+        .value("TYPE_II", TapeType::TypeII)
+        .value("MODERN", TapeType::Modern);
+
+    py::enum_<QualityMode>(m, "QualityMode")
+        .value("ECO", QualityMode::Eco)
+        .value("STANDARD", QualityMode::Standard)
+        .value("HQ", QualityMode::HQ);
+
+    py::enum_<AntialiasingMode>(m, "AntialiasingMode")
+        .value("OVERSAMPLING", AntialiasingMode::Oversampling)
+        .value("ADAA1", AntialiasingMode::ADAA1)
+        .value("ADAA2", AntialiasingMode::ADAA2);
+
+    py::enum_<ResponseMode>(m, "ResponseMode")
+        .value("FILTERS", ResponseMode::Filters)
+        .value("CONVOLUTION", ResponseMode::Convolution);
+
+    py::enum_<EmphasisMode>(m, "EmphasisMode")
+        .value("OFF", EmphasisMode::Off)
+        .value("NAB", EmphasisMode::NAB)
+        .value("IEC", EmphasisMode::IEC);
+
+    py::class_<PythonProcessor> processor(m, "TapeProcessor");
+    processor.def(py::init<>());
+
+    for (const auto& parameter : floatParameters)
+    {
+        processor.def(("set_" + std::string(parameter.name)).c_str(),
+                      [set = parameter.set](PythonProcessor& self, float value)
+                      {
+                          const std::lock_guard<std::mutex> guard(self.lock);
+                          (self.processor.*set)(value);
+                      },
+                      py::arg("value"), parameter.range);
+    }
+
+    for (const auto& parameter : choiceParameters)
+    {
+        processor.def(("set_" + std::string(parameter.name)).c_str(),
+                      [set = parameter.set](PythonProcessor& self, const py::object& value)
+                      {
+                          const int choice = toChoice(value);
+                          const std::lock_guard<std::mutex> guard(self.lock);
+                          (self.processor.*set)(choice);
+                      },
+                      py::arg("value"), parameter.range);
+    }
+
+    processor
+        .def("set_timeline", [](PythonProcessor& self, uint32_t seed)
+        {
+            const std::lock_guard<std::mutex> guard(self.lock);
+            if (self.prepared)
+                throw py::value_error("set_timeline() must be called before prepare()");
+
+            self.processor.setTimeline(seed);
+            self.timeline = true;
+        }, py::arg("seed"), "Wow/flutter and hiss follow the sample position and the seed (call before prepare)")
+        .def("seek_timeline", [](PythonProcessor& self, int64_t position)
+        {
+            const std::lock_guard<std::mutex> guard(self.lock);
+            if (! self.prepared || ! self.timeline)
+                throw py::value_error("seek_timeline() needs set_timeline() and prepare() first");
+            if (position < 0 || position % TapeProcessor::TIMELINE_ALIGNMENT != 0)
+                throw py::value_error("position must be a non-negative multiple of "
+                                      + std::to_string(TapeProcessor::TIMELINE_ALIGNMENT));
+
+            self.processor.seekTimeline(position);
+        }, py::arg("position"))
+        .def("prepare", [](PythonProcessor& self, double sampleRate, int maxBlockSize)
+        {
+            if (sampleRate <= 0.0 || maxBlockSize <= 0)
+                throw py::value_error("sample_rate and max_block_size must be positive");
+
+            const std::lock_guard<std::mutex> guard(self.lock);
+            self.processor.prepare(sampleRate, maxBlockSize);
+            self.prepared = true;
+        }, py::arg("sample_rate"), py::arg("max_block_size") = OfflineRenderer::BLOCK_SIZE)
+        .def("reset", [](PythonProcessor& self)
+        {
+            const std::lock_guard<std::mutex> guard(self.lock);
+            self.processor.reset();
+        })
+        .def("process", [](PythonProcessor& self, const py::object& audio)
+        {
+            const auto clip = viewOf(audio);
+            juce::AudioBuffer<float> buffer(clip.channels, clip.numChannels, clip.numSamples);
+
+            bool prepared = false;
+            {
+                py::gil_scoped_release release;
+                const std::lock_guard<std::mutex> guard(self.lock);
+                prepared = self.prepared;
+                if (prepared)
+                    self.processor.process(buffer);
+            }
+
+            if (! prepared)
+                throw py::value_error("prepare() must be called before process()");
+        }, py::arg("audio"),
+           "Processes a float32 array of shape (samples,) or (channels, samples) in place, without the GIL. "
+           "Like the plugin, the output is delayed by latency samples")
+        .def_property_readonly("latency", [](PythonProcessor& self)
+        {
+            const std::lock_guard<std::mutex> guard(self.lock);
+            return self.processor.getLatencySamples();
+        });
+
+    m.def("process_batch", [](const py::sequence& clips, double sampleRate, const py::dict& settings,
+                              int numThreads, uint32_t seed)
+    {
+        if (sampleRate <= 0.0)
+            throw py::value_error("sample_rate must be positive");
+
+        // Items of a sequence may be temporaries (rows of a 3-D array), so
+        // they are held until processing is done
+        std::vector<py::object> items;
+        std::vector<OfflineRenderer::Clip> views;
+        items.reserve(clips.size());
+        views.reserve(clips.size());
+
+        for (const auto& item : clips)
+        {
+            items.push_back(item);
+            views.push_back(viewOf(items.back()));
+        }
+
+        const auto configure = parseSettings(settings);
+
+        OfflineRenderer::Options options;
+        options.numThreads = numThreads;
+        options.seed = seed;
+
+        py::gil_scoped_release release;
+        OfflineRenderer::renderClips(views, sampleRate, configure, options);
+    }, py::arg("clips"), py::arg("sample_rate"), py::arg("settings") = py::dict(), py::arg("num_threads") = 0,
+       py::arg("seed") = 1,
+       "Processes each clip (a float32 array as for TapeProcessor.process, or rows of a 3-D array) in place on "
+       "num_threads threads (0 for one per core). Settings map setter names without set_ to values. Each clip "
+       "starts from a reset processor and is latency compensated, so results do not depend on the threading");
+}
@@ -0,0 +1,264 @@
+#include "TraceRecorder.h"
+#include "DSP/TapeProcessor.h"
+#include "DSP/RealtimeChecker.h"
+#include <chrono>
+#include <mutex>
+
+//==============================================================================
+// Owns the trace file and drains every registered recorder. It lives while
+// any instance does; if all are deleted and new ones created later in the
+// session, the next writer appends to the same file. The closing ']' is
+// optional in the trace format, so files from crashed sessions still load.
+class TraceRecorder::Writer : private juce::Thread
+{
+public:
+    // Returns nullptr unless TAPEWARM_TRACE names a writable file
+    static std::shared_ptr<Writer> acquire()
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<Writer> shared;
+        static bool fileStarted = false;
+
+        RealtimeChecker::checkBlockingCall("trace writer lock");
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto writer = shared.lock();
+        if (writer == nullptr)
+        {
+            const auto path = juce::SystemStats::getEnvironmentVariable("TAPEWARM_TRACE", {});
+            if (path.isEmpty() || ! juce::File::isAbsolutePath(path))
+                return nullptr;
+
+            juce::File file(path);
+            if (! fileStarted)
+                file.deleteFile();
+
+            // FileOutputStream appends to an existing file
+            auto stream = std::make_unique<juce::FileOutputStream>(file);
+            if (! stream->openedOk())
+                return nullptr;
+
+            writer = std::make_shared<Writer>(std::move(stream), ! fileStarted);
+            shared = writer;
+            fileStarted = true;
+        }
+
+        return writer;
+    }
+
+    Writer(std::unique_ptr<juce::FileOutputStream> outputStream, bool newFile)
+        : juce::Thread("TapeWarm trace writer"), stream(std::move(outputStream)), firstEvent(newFile)
+    {
+        if (newFile)
+            *stream << "[\n";
+
+        startThread(juce::Thread::Priority::background);
+    }
+
+    ~Writer() override
+    {
+        stopThread(1000);
+    }
+
+    int add(TraceRecorder* recorder)
+    {
+        static std::atomic<int> numInstances { 0 };
+
+        RealtimeChecker::checkBlockingCall("trace writer lock");
+        const juce::ScopedLock lock(recordersLock);
+        recorders.add(recorder);
+
+        // Name the track after the instance
+        const int instance = ++numInstances;
+        writeSeparator();
+        *stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << instance
+                << ",\"args\":{\"name\":\"TapeWarm #" << instance << "\"}}";
+        return instance;
+    }
+
+    void remove(TraceRecorder* recorder)
+    {
+        // Flush what is left before the recorder goes away
+        RealtimeChecker::checkBlockingCall("trace writer lock");
+        const juce::ScopedLock lock(recordersLock);
+        recorder->writeEvents(*stream, firstEvent);
+        recorders.removeFirstMatchingValue(recorder);
+        stream->flush();
+    }
+
+private:
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait(100);
+
+            const juce::ScopedLock lock(recordersLock);
+            for (auto* recorder : recorders)
+                recorder->writeEvents(*stream, firstEvent);
+            stream->flush();
+        }
+    }
+
+    void writeSeparator()
+    {
+        if (! firstEvent)
+            *stream << ",\n";
+        firstEvent = false;
+    }
+
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::CriticalSection recordersLock;
+    juce::Array<TraceRecorder*> recorders;
+    bool firstEvent;
+};
+
+//==============================================================================
+TraceRecorder::TraceRecorder(const juce::Array<juce::AudioProcessorParameter*>& parametersToTrace)
+    : writer(Writer::acquire())
+{
+    if (writer == nullptr)
+        return;
+
+    parameters = parametersToTrace;
+    for (auto* parameter : parameters)
+    {
+        lastValues.push_back(parameter->getValue());
+
+        auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter);
+        parameterIds.add(withID != nullptr ? withID->getParameterID() : parameter->getName(64));
+    }
+
+    events.allocate(FIFO_SIZE, true);
+    instanceNumber = writer->add(this);
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    if (writer != nullptr)
+        writer->remove(this);
+}
+
+int64_t TraceRecorder::now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::beginBlock() noexcept
+{
+    if (writer == nullptr)
+        return;
+
+    blockStart = now();
+
+    // Parameter changes since the previous block, stamped at its start
+    for (int i = 0; i < parameters.size(); ++i)
+    {
+        const float value = parameters.getUnchecked(i)->getValue();
+        if (juce::exactlyEqual(value, lastValues[static_cast<size_t>(i)]))
+            continue;
+
+        lastValues[static_cast<size_t>(i)] = value;
+
+        Event event;
+        event.type = Event::Type::ParameterChange;
+        event.start = event.end = blockStart;
+        event.parameterIndex = i;
+        event.value = value;
+        push(event);
+    }
+}
+
+void TraceRecorder::endBlock(int numSamples, uint32_t activeStages) noexcept
+{
+    if (writer == nullptr)
+        return;
+
+    Event event;
+    event.start = blockStart;
+    event.end = now();
+    event.numSamples = numSamples;
+    event.activeStages = activeStages;
+    push(event);
+}
+
+void TraceRecorder::push(const Event& event) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    // Writer thread has fallen behind: count it rather than block
+    if (size1 == 0)
+    {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    events[start1] = event;
+    fifo.finishedWrite(1);
+}
+
+void TraceRecorder::writeEvents(juce::OutputStream& stream, bool& firstEvent)
+{
+    static const std::pair<uint32_t, const char*> stageNames[] =
+    {
+        { TapeProcessor::OversamplingStage,   "oversampling" },
+        { TapeProcessor::HeadBumpStage,       "headBump" },
+        { TapeProcessor::WowFlutterStage,     "wowFlutter" },
+        { TapeProcessor::HissStage,           "hiss" },
+        { TapeProcessor::DualMonoStage,       "dualMono" },
+        { TapeProcessor::AntiderivativeStage, "adaa" },
+        { TapeProcessor::ConvolutionStage,    "machineResponse" },
+        { TapeProcessor::BypassedStage,       "bypassed" }
+    };
+
+    const auto toMicroseconds = [](int64_t ns) { return juce::String(static_cast<double>(ns) / 1000.0, 3); };
+
+    const auto writeSeparator = [&]
+    {
+        if (! firstEvent)
+            stream << ",\n";
+        firstEvent = false;
+    };
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1 + size2; ++i)
+    {
+        const auto& event = events[i < size1 ? start1 + i : start2 + i - size1];
+        writeSeparator();
+
+        if (event.type == Event::Type::ParameterChange)
+        {
+            auto* parameter = parameters.getUnchecked(event.parameterIndex);
+
+            stream << "{\"name\":\"" << parameterIds[event.parameterIndex] << "\",\"cat\":\"parameter\",\"ph\":\"i\",\"s\":\"t\""
+                   << ",\"ts\":" << toMicroseconds(event.start) << ",\"pid\":1,\"tid\":" << instanceNumber
+                   << ",\"args\":{\"value\":" << juce::String(event.value, 4)
+                   << ",\"text\":\"" << parameter->getText(event.value, 32) << "\"}}";
+            continue;
+        }
+
+        juce::StringArray stages;
+        for (const auto& [flag, name] : stageNames)
+            if ((event.activeStages & flag) != 0)
+                stages.add(name);
+
+        stream << "{\"name\":\"process\",\"cat\":\"dsp\",\"ph\":\"X\""
+               << ",\"ts\":" << toMicroseconds(event.start) << ",\"dur\":" << toMicroseconds(event.end - event.start)
+               << ",\"pid\":1,\"tid\":" << instanceNumber
+               << ",\"args\":{\"samples\":" << event.numSamples
+               << ",\"stages\":\"" << stages.joinIntoString(",") << "\"}}";
+    }
+
+    fifo.finishedRead(size1 + size2);
+
+    if (const int dropped = droppedEvents.exchange(0); dropped > 0)
+    {
+        writeSeparator();
+        stream << "{\"name\":\"dropped " << dropped << " events\",\"ph\":\"i\",\"s\":\"t\""
+               << ",\"ts\":" << toMicroseconds(now()) << ",\"pid\":1,\"tid\":" << instanceNumber << "}";
+    }
+}
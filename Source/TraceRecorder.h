@@ -0,0 +1,66 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+// Opt-in trace of per-block DSP timing for offline analysis.
+//
+// Set TAPEWARM_TRACE to an output path before starting the host. Every
+// instance then records block timestamps, block size, active stages and
+// parameter changes into its own preallocated FIFO, and one background
+// thread per process writes all of them to a single Chrome trace (JSON
+// array format; open in Perfetto or chrome://tracing). Without the
+// variable nothing is allocated and the audio thread only tests a pointer.
+class TraceRecorder
+{
+public:
+    // Call from the processor constructor, after the parameters exist
+    explicit TraceRecorder(const juce::Array<juce::AudioProcessorParameter*>& parametersToTrace);
+    ~TraceRecorder();
+
+    bool isEnabled() const { return writer != nullptr; }
+
+    // Audio thread: bracket the DSP of each block. activeStages is a
+    // TapeProcessor::ActiveStage mask.
+    void beginBlock() noexcept;
+    void endBlock(int numSamples, uint32_t activeStages) noexcept;
+
+private:
+    class Writer;
+
+    struct Event
+    {
+        enum class Type : uint8_t { Block, ParameterChange };
+
+        Type type = Type::Block;
+        int64_t start = 0;              // Steady clock, ns
+        int64_t end = 0;
+        int numSamples = 0;
+        uint32_t activeStages = 0;
+        int parameterIndex = 0;
+        float value = 0.0f;             // Normalised
+    };
+
+    static constexpr int FIFO_SIZE = 8192;  // ~10 s of 64-sample blocks at 48 kHz
+
+    static int64_t now() noexcept;
+    void push(const Event& event) noexcept;
+
+    // Writer thread: drains the FIFO into the trace
+    void writeEvents(juce::OutputStream& stream, bool& firstEvent);
+
+    std::shared_ptr<Writer> writer;
+    int instanceNumber = 0;
+
+    juce::Array<juce::AudioProcessorParameter*> parameters;
+    juce::StringArray parameterIds;
+    std::vector<float> lastValues;
+
+    juce::AbstractFifo fifo { FIFO_SIZE };
+    juce::HeapBlock<Event> events;
+    std::atomic<int> droppedEvents { 0 };
+    int64_t blockStart = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(TraceRecorder)
+};
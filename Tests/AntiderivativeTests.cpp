@@ -0,0 +1,110 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/DSPUtils.h"
+
+// The ADAA curves: each antiderivative differentiates to the one below it,
+// and the anti-aliased outputs reduce to the curve where the input is steady
+class AntiderivativeTests : public juce::UnitTest
+{
+public:
+    AntiderivativeTests() : juce::UnitTest("Antiderivative curves", "TapeWarm") {}
+
+    void runTest() override
+    {
+        beginTest("tanhAntiderivative2");
+        {
+            expectWithinAbsoluteError(DSPUtils::tanhAntiderivative2(0.0), 0.0, 1.0e-15);
+
+            // Closed form against Simpson's rule over ln(cosh t) from 0
+            for (double x : { 0.01, 0.3, 1.0, 2.5, 6.0, 15.0 })
+            {
+                expectWithinAbsoluteError(DSPUtils::tanhAntiderivative2(x), integrateLogCosh(x), 1.0e-10,
+                                          "at " + juce::String(x));
+                expectWithinAbsoluteError(DSPUtils::tanhAntiderivative2(-x), -DSPUtils::tanhAntiderivative2(x), 1.0e-15);
+            }
+
+            expectLessThan(maxDerivativeError([](double x) { return DSPUtils::tanhAntiderivative2(x); },
+                                              [](double x) { return DSPUtils::logCosh(x); }), 1.0e-7);
+            expectLessThan(maxDerivativeError([](double x) { return DSPUtils::logCosh(x); },
+                                              [](double x) { return std::tanh(x); }), 1.0e-7);
+        }
+
+        beginTest("SoftKneeCurve antiderivatives");
+        {
+            const DSPUtils::SoftKneeCurve curve;
+            expectLessThan(maxDerivativeError([&](double x) { return curve.antiderivative1(x); },
+                                              [&](double x) { return curve.value(x); }), 1.0e-7);
+            expectLessThan(maxDerivativeError([&](double x) { return curve.antiderivative2(x); },
+                                              [&](double x) { return curve.antiderivative1(x); }), 1.0e-7);
+        }
+
+        beginTest("Steady input");
+        {
+            testSteadyInput(DSPUtils::TanhCurve());
+            testSteadyInput(DSPUtils::SoftKneeCurve());
+        }
+
+        beginTest("Repeated inputs stay finite");
+        {
+            // x == x2 and x == x1 take the limit branches of adaa2
+            DSPUtils::AntiderivativeState state;
+            const DSPUtils::TanhCurve curve;
+            bool finite = true;
+
+            for (float input : { 0.5f, 0.8f, 0.5f, 0.5f, 0.5f, -3.0f, 3.0f, -3.0f, 1.0e-7f, 0.0f, 1.0e-7f })
+                finite = finite && std::isfinite(DSPUtils::adaa2(curve, input, state));
+
+            expect(finite);
+        }
+    }
+
+private:
+    static double integrateLogCosh(double x)
+    {
+        constexpr int intervals = 20000;
+        const double h = x / intervals;
+        double sum = DSPUtils::logCosh(0.0) + DSPUtils::logCosh(x);
+
+        for (int i = 1; i < intervals; ++i)
+            sum += DSPUtils::logCosh(i * h) * ((i % 2 != 0) ? 4.0 : 2.0);
+
+        return sum * h / 3.0;
+    }
+
+    // Largest difference between a central difference of f and g over
+    // [-8, 8], relative to max(1, |g|)
+    template <typename F, typename G>
+    static double maxDerivativeError(F f, G g)
+    {
+        constexpr double h = 1.0e-5;
+        double maxError = 0.0;
+
+        for (double x = -8.0; x <= 8.0; x += 0.0137)
+        {
+            const double derivative = (f(x + h) - f(x - h)) / (2.0 * h);
+            maxError = std::max(maxError, std::abs(derivative - g(x)) / std::max(1.0, std::abs(g(x))));
+        }
+
+        return maxError;
+    }
+
+    template <typename Curve>
+    void testSteadyInput(const Curve& curve)
+    {
+        for (float input : { -4.0f, -0.6f, 0.2f, 0.9f, 2.0f })
+        {
+            DSPUtils::AntiderivativeState first, second;
+            float y1 = 0.0f, y2 = 0.0f;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                y1 = DSPUtils::adaa1(curve, input, first);
+                y2 = DSPUtils::adaa2(curve, input, second);
+            }
+
+            expectWithinAbsoluteError(y1, static_cast<float>(curve.value(input)), 1.0e-6f);
+            expectWithinAbsoluteError(y2, static_cast<float>(curve.value(input)), 1.0e-6f);
+        }
+    }
+};
+
+static AntiderivativeTests antiderivativeTests;
@@ -0,0 +1,77 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/TapeProcessor.h"
+
+// Record pre-emphasis followed by playback de-emphasis is transparent, for
+// every standard, speed and common rate
+class EmphasisTests : public juce::UnitTest
+{
+public:
+    EmphasisTests() : juce::UnitTest("Emphasis round trip", "TapeWarm") {}
+
+    void runTest() override
+    {
+        for (auto mode : { EmphasisMode::NAB, EmphasisMode::IEC })
+        {
+            beginTest(mode == EmphasisMode::NAB ? "NAB" : "IEC");
+
+            for (int m = 0; m < TapeCharacteristics::NUM_MACHINE_TYPES; ++m)
+            {
+                for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+                {
+                    TapeKernels::BiquadCoefficients record, playback;
+                    TapeProcessor::calculateEmphasis(mode, static_cast<MachineType>(m), sampleRate, record, playback);
+
+                    // Limited boost: +12 dB at most at Nyquist, and the NAB bass cut at DC
+                    const double dcGain = (record.b0 + record.b1 + record.b2) / (1.0 + record.a1 + record.a2);
+                    const double nyquistGain = (record.b0 - record.b1 + record.b2) / (1.0 - record.a1 + record.a2);
+                    const double expectedDc = TapeCharacteristics::getEmphasis(mode, static_cast<MachineType>(m))
+                                                  .lowTimeConstant > 0.0f ? 0.5 : 1.0;
+
+                    expectWithinAbsoluteError(dcGain, expectedDc, 1.0e-3);
+                    expectGreaterThan(nyquistGain, 1.0);
+                    expectLessOrEqual(nyquistGain, 4.0 + 1.0e-4);
+
+                    expectLessThan(getRoundTripError(record, playback), 1.0e-4f,
+                                   "machine " + juce::String(m) + " at " + juce::String(sampleRate));
+                }
+            }
+        }
+
+        beginTest("Off is unity");
+        {
+            TapeKernels::BiquadCoefficients record, playback;
+            record.b0 = playback.b0 = 2.0f;
+            TapeProcessor::calculateEmphasis(EmphasisMode::Off, MachineType::IPS_15, 48000.0, record, playback);
+            expect(juce::exactlyEqual(record.b0, 1.0f) && juce::exactlyEqual(record.a1, 0.0f));
+            expect(juce::exactlyEqual(playback.b0, 1.0f) && juce::exactlyEqual(playback.a1, 0.0f));
+        }
+    }
+
+private:
+    // Peak difference between a second of noise and the noise through the
+    // record and playback filters in series
+    static float getRoundTripError(const TapeKernels::BiquadCoefficients& record,
+                                   const TapeKernels::BiquadCoefficients& playback)
+    {
+        const auto& kernels = TapeKernels::selectKernels();
+        DSPUtils::NoiseGenerator noise;
+        noise.setSeed(7);
+
+        std::vector<float> input(48000), output(48000);
+        for (auto& sample : input)
+            sample = 0.5f * noise.nextSample();
+
+        output = input;
+        TapeKernels::BiquadState recordState, playbackState;
+        kernels.biquad(output.data(), static_cast<int>(output.size()), record, recordState);
+        kernels.biquad(output.data(), static_cast<int>(output.size()), playback, playbackState);
+
+        float maxError = 0.0f;
+        for (size_t i = 0; i < input.size(); ++i)
+            maxError = std::max(maxError, std::abs(output[i] - input[i]));
+
+        return maxError;
+    }
+};
+
+static EmphasisTests emphasisTests;
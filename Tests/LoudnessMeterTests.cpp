@@ -0,0 +1,125 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/LoudnessMeter.h"
+#include <cmath>
+
+// The BS.1770 calibration points (a 997 Hz sine at full scale on two
+// channels reads 0 LUFS, -20 dBFS on one channel -23.01 LUFS), gating, and
+// a true peak that falls between samples. Tolerances are EBU Tech 3341's
+class LoudnessMeterTests : public juce::UnitTest
+{
+public:
+    LoudnessMeterTests() : juce::UnitTest("Loudness meter", "TapeWarm") {}
+
+    void runTest() override
+    {
+        for (double sampleRate : { 44100.0, 48000.0 })
+        {
+            const juce::String rate = " at " + juce::String(sampleRate) + " Hz";
+
+            beginTest("997 Hz full scale, stereo" + rate);
+            {
+                LoudnessMeter meter;
+                meter.prepare(sampleRate, 2);
+
+                Generator generator(sampleRate);
+                generator.push(meter, 2, 10.0, 1.0f);
+                expectLoudness(meter, 0.0f);
+            }
+
+            beginTest("997 Hz at -20 dBFS, mono" + rate);
+            {
+                LoudnessMeter meter;
+                meter.prepare(sampleRate, 1);
+
+                Generator generator(sampleRate);
+                generator.push(meter, 1, 10.0, 0.1f);
+                expectLoudness(meter, -23.01f);
+            }
+        }
+
+        beginTest("Gating");
+        {
+            // Silence falls under the absolute gate, and the -40 dBFS tail
+            // under the relative gate, 10 LU below the -23 LUFS tone
+            LoudnessMeter meter;
+            meter.prepare(48000.0, 1);
+
+            Generator generator(48000.0);
+            generator.push(meter, 1, 10.0, 0.0f);
+            generator.push(meter, 1, 30.0, 0.1f);
+            generator.push(meter, 1, 10.0, 0.01f);
+
+            logMessage("Integrated " + juce::String(meter.getIntegrated(), 3) + " LUFS");
+            expectWithinAbsoluteError(meter.getIntegrated(), -23.01f, 0.1f);
+        }
+
+        beginTest("Inter-sample true peak");
+        {
+            // A quarter of the sample rate at 45 degrees: every sample is at
+            // 0.707, -3.01 dBFS, and the waveform peaks at full scale between them
+            LoudnessMeter meter;
+            meter.prepare(48000.0, 1);
+
+            Generator generator(48000.0, 12000.0, juce::MathConstants<double>::pi / 4.0);
+            generator.push(meter, 1, 1.0, 1.0f);
+
+            logMessage("True peak " + juce::String(meter.getTruePeak(), 3) + " dBTP");
+            expectGreaterOrEqual(meter.getTruePeak(), -0.4f);
+            expectLessOrEqual(meter.getTruePeak(), 0.2f);
+        }
+    }
+
+private:
+    // A continuous sine, pushed in segments of any level
+    class Generator
+    {
+    public:
+        explicit Generator(double sampleRateToUse, double frequency = 997.0, double startPhase = 0.0)
+            : sampleRate(sampleRateToUse),
+              increment(juce::MathConstants<double>::twoPi * frequency / sampleRateToUse),
+              phase(startPhase)
+        {
+        }
+
+        // Waits for the analysis thread after each block, so nothing is dropped
+        // from the meter's FIFO and the results cover all of it on return
+        void push(LoudnessMeter& meter, int numChannels, double seconds, float gain)
+        {
+            constexpr int blockSize = 8192;
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+
+            for (auto remaining = static_cast<int>(sampleRate * seconds); remaining > 0; remaining -= blockSize)
+            {
+                const int length = std::min(blockSize, remaining);
+                buffer.setSize(numChannels, length, false, false, true);
+
+                for (int i = 0; i < length; ++i)
+                {
+                    const auto sample = gain * static_cast<float>(std::sin(phase));
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        buffer.setSample(ch, i, sample);
+                    phase += increment;
+                }
+
+                meter.push(buffer);
+
+                const auto deadline = juce::Time::getMillisecondCounter() + 5000;
+                while (meter.hasPendingSamples() && juce::Time::getMillisecondCounter() < deadline)
+                    juce::Thread::sleep(1);
+            }
+        }
+
+    private:
+        double sampleRate, increment, phase;
+    };
+
+    void expectLoudness(const LoudnessMeter& meter, float expected)
+    {
+        logMessage("Integrated " + juce::String(meter.getIntegrated(), 3) + " LUFS, short-term "
+                   + juce::String(meter.getShortTerm(), 3) + " LUFS");
+        expectWithinAbsoluteError(meter.getIntegrated(), expected, 0.1f);
+        expectWithinAbsoluteError(meter.getShortTerm(), expected, 0.1f);
+    }
+};
+
+static LoudnessMeterTests loudnessMeterTests;
@@ -0,0 +1,93 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/OfflineRenderer.h"
+#include <chrono>
+
+// Chunked renders against a serial, single-chunk render of the same input,
+// with every stage on, and the speedup the chunking buys on this machine
+class OfflineRendererTests : public juce::UnitTest
+{
+public:
+    OfflineRendererTests() : juce::UnitTest("Offline renderer", "TapeWarm") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        const auto input = makeInput(sampleRate, 16.0);
+
+        for (const auto responseMode : { ResponseMode::Filters, ResponseMode::Convolution })
+        {
+            for (int tapeType = 0; tapeType < TapeCharacteristics::NUM_TAPE_TYPES; ++tapeType)
+            {
+                beginTest("Chunked matches serial, tape type " + juce::String(tapeType)
+                          + (responseMode == ResponseMode::Convolution ? ", convolution" : ", filters"));
+
+                const auto configure = [=](TapeProcessor& processor)
+                {
+                    processor.setTapeType(tapeType);
+                    processor.setResponseMode(static_cast<int>(responseMode));
+                    processor.setInputDrive(9.0f);
+                    processor.setSaturation(90.0f);
+                    processor.setHeadBump(80.0f);
+                    processor.setWow(60.0f);
+                    processor.setFlutter(40.0f);
+                    processor.setHiss(30.0f);
+                    processor.setWarmth(70.0f);
+                    processor.setAge(40.0f);
+                    processor.setEmphasis(2);
+                    processor.setMix(85.0f);
+                };
+
+                OfflineRenderer::Options serialOptions;
+                serialOptions.numThreads = 1;
+                serialOptions.chunkSeconds = 1000.0;
+
+                OfflineRenderer::Options chunkedOptions;
+                chunkedOptions.chunkSeconds = 2.0;
+
+                juce::AudioBuffer<float> serial, chunked;
+                const double serialSeconds = timeRender(input, serial, sampleRate, configure, serialOptions);
+                const double chunkedSeconds = timeRender(input, chunked, sampleRate, configure, chunkedOptions);
+
+                const float difference = getPeakDifference(serial, chunked);
+                logMessage("Peak difference " + juce::String(difference, 10) + ", serial " + juce::String(serialSeconds, 3)
+                           + " s, chunked on " + juce::String(juce::SystemStats::getNumCpus()) + " threads "
+                           + juce::String(chunkedSeconds, 3) + " s, speedup " + juce::String(serialSeconds / chunkedSeconds, 2) + "x");
+                expectLessOrEqual(difference, OfflineRenderer::NULL_TOLERANCE);
+            }
+        }
+    }
+
+private:
+    // Stereo: a sine per channel, louder than full scale after the drive, and noise
+    static juce::AudioBuffer<float> makeInput(double sampleRate, double seconds)
+    {
+        juce::AudioBuffer<float> buffer(2, static_cast<int>(sampleRate * seconds));
+        juce::Random random(3);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, 0.7f * std::sin(0.01f * static_cast<float>(i * (ch + 1)))
+                                        + 0.2f * (random.nextFloat() - 0.5f));
+
+        return buffer;
+    }
+
+    static double timeRender(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, double sampleRate,
+                             const OfflineRenderer::Configure& configure, const OfflineRenderer::Options& options)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        OfflineRenderer::render(input, output, sampleRate, configure, options);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static float getPeakDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        float peak = 0.0f;
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                peak = std::max(peak, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+        return peak;
+    }
+};
+
+static OfflineRendererTests offlineRendererTests;
@@ -0,0 +1,86 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/PlaybackLoss.h"
+#include "../Source/DSP/TapeModel.h"
+#include <complex>
+
+// PlaybackLoss::design against the loss model it fits, over every machine
+// and tape, with the extra coating depth and spacing Warmth and Age add
+class PlaybackLossTests : public juce::UnitTest
+{
+public:
+    PlaybackLossTests() : juce::UnitTest("Playback loss fit", "TapeWarm") {}
+
+    void runTest() override
+    {
+        const auto models = TapeModelSet::acquire();
+
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        {
+            beginTest("Fit error at " + juce::String(sampleRate) + " Hz");
+
+            double worst = 0.0, worstDefault = 0.0;
+
+            for (int m = 0; m < TapeCharacteristics::NUM_MACHINE_TYPES; ++m)
+            {
+                for (int t = 0; t < TapeCharacteristics::NUM_TAPE_TYPES; ++t)
+                {
+                    const auto& model = models->get(static_cast<MachineType>(m), static_cast<TapeType>(t),
+                                                    QualityMode::Standard);
+
+                    for (double depth : { 0.0, 1.0, 2.0 })
+                    {
+                        for (double spacing : { 0.0, 1.0 })
+                        {
+                            PlaybackLoss::Geometry geometry;
+                            geometry.speed = model.tapeSpeed;
+                            geometry.gap = model.gapWidth;
+                            geometry.spacing = model.headSpacing + spacing;
+                            geometry.thickness = model.coatingThickness + depth;
+
+                            const double error = getFitError(geometry, sampleRate);
+                            worst = std::max(worst, error);
+                            if (juce::exactlyEqual(depth, 1.0) && juce::exactlyEqual(spacing, 0.0))
+                                worstDefault = std::max(worstDefault, error);
+                        }
+                    }
+                }
+            }
+
+            logMessage("Largest error " + juce::String(worst, 3) + " dB, at Warmth 50% and Age 0% "
+                       + juce::String(worstDefault, 3) + " dB");
+            expectLessThan(worstDefault, 0.5);
+            expectLessThan(worst, 1.0);
+        }
+    }
+
+private:
+    // Largest difference in dB between the designed sections and the model,
+    // from 20 Hz to 20 kHz (or 0.45 fs)
+    static double getFitError(const PlaybackLoss::Geometry& geometry, double sampleRate)
+    {
+        TapeKernels::BiquadCoefficients sections[PlaybackLoss::NUM_SECTIONS];
+        PlaybackLoss::design(geometry, sampleRate, sections);
+
+        const double high = std::min(20000.0, 0.45 * sampleRate);
+        double maxError = 0.0;
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const double frequency = 20.0 * std::pow(high / 20.0, i / 199.0);
+            const auto z1 = std::polar(1.0, -2.0 * juce::MathConstants<double>::pi * frequency / sampleRate);
+            const auto z2 = z1 * z1;
+
+            std::complex<double> response = 1.0;
+            for (const auto& s : sections)
+                response *= (static_cast<double>(s.b0) + static_cast<double>(s.b1) * z1 + static_cast<double>(s.b2) * z2)
+                          / (1.0 + static_cast<double>(s.a1) * z1 + static_cast<double>(s.a2) * z2);
+
+            const double error = 20.0 * std::log10(std::abs(response)) - PlaybackLoss::getLossDecibels(geometry, frequency);
+            maxError = std::max(maxError, std::abs(error));
+        }
+
+        return maxError;
+    }
+};
+
+static PlaybackLossTests playbackLossTests;
@@ -0,0 +1,205 @@
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/DSP/RealtimeChecker.h"
+#include <condition_variable>
+#include <mutex>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <unistd.h>
+#endif
+
+// Built into TapeWarmRealtimeTests, with the realtime checker on: drives the
+// plugin through every parameter value, re-prepares and bus layouts, and
+// fails on any allocation, deallocation or blocking call inside processBlock.
+// On Linux and macOS it also checks that the checker sees OS locks and
+// system calls
+class RealtimeSweepTests : public juce::UnitTest
+{
+public:
+    RealtimeSweepTests() : juce::UnitTest("Realtime sweep", "TapeWarm") {}
+
+    void runTest() override
+    {
+        juce::ScopedJuceInitialiser_GUI juceInitialiser;
+        TapeWarmAudioProcessor processor;
+
+        const std::pair<double, int> prepares[] = { { 44100.0, 512 }, { 48000.0, 64 }, { 96000.0, 1024 }, { 192000.0, 2048 } };
+
+        for (const auto& channels : { juce::AudioChannelSet::stereo(), juce::AudioChannelSet::mono() })
+        {
+            beginTest("Parameter sweep, " + channels.getDescription());
+
+            // Hosts release before changing the layout
+            processor.releaseResources();
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(channels);
+            layout.outputBuses.add(channels);
+            expect(processor.setBusesLayout(layout));
+
+            for (const auto& [sampleRate, blockSize] : prepares)
+            {
+                prepare(processor, sampleRate, blockSize);
+                checkBlocks(processor, "after prepareToPlay at " + juce::String(sampleRate));
+
+                // Some hosts prepare again without releasing first
+                prepare(processor, sampleRate, blockSize);
+                checkBlocks(processor, "after a second prepareToPlay");
+
+                for (auto* parameter : processor.getParameters())
+                    sweepParameter(processor, *static_cast<juce::RangedAudioParameter*>(parameter));
+            }
+
+            beginTest("Quality, anti-aliasing and tape type, " + channels.getDescription());
+            prepare(processor, 48000.0, 512);
+            sweepPathChanges(processor);
+
+            beginTest("Offline rendering and host bypass, " + channels.getDescription());
+            processor.setNonRealtime(true);
+            prepare(processor, 48000.0, 512);
+            checkBlocks(processor, "rendering offline");
+            processor.setNonRealtime(false);
+            prepare(processor, 48000.0, 512);
+
+            const int before = RealtimeChecker::getNumViolations();
+            fillNoise();
+            for (int i = 0; i < 8; ++i)
+            {
+                auto view = getBlock(processor, blockSizes[i % numBlockSizes]);
+                processor.processBlockBypassed(view, midi);
+            }
+            expectEquals(RealtimeChecker::getNumViolations() - before, 0, "in processBlockBypassed");
+        }
+
+        processor.releaseResources();
+
+       #if JUCE_LINUX || JUCE_MAC
+        beginTest("Checker sees locks, waits and system calls");
+        {
+            juce::CriticalSection criticalSection;
+            expectSeen("CriticalSection", [&] { const juce::ScopedLock lock(criticalSection); });
+            expectSeen("write", [] { const char none = 0; juce::ignoreUnused(write(STDOUT_FILENO, &none, 0)); });
+            expectSeen("usleep", [] { usleep(1); });
+
+           #if JUCE_LINUX
+            // Inline on Linux; inside the C++ library on macOS, where only
+            // the explicit marks see it
+            std::mutex mutex;
+            std::condition_variable condition;
+            expectSeen("std::mutex", [&] { const std::lock_guard<std::mutex> lock(mutex); });
+
+            std::unique_lock<std::mutex> lock(mutex);
+            expectSeen("std::condition_variable", [&] { condition.wait_for(lock, std::chrono::microseconds(1)); });
+           #endif
+        }
+       #endif
+    }
+
+private:
+    static constexpr int numBlockSizes = 4;
+    static constexpr int blockSizes[numBlockSizes] = { 512, 1, 173, 2048 };
+
+    juce::AudioBuffer<float> buffer { 2, 2048 };
+    juce::MidiBuffer midi;
+    juce::Random random { 1 };
+    int preparedBlockSize = 512;
+
+    void prepare(TapeWarmAudioProcessor& processor, double sampleRate, int blockSize)
+    {
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        preparedBlockSize = blockSize;
+    }
+
+    void fillNoise()
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, random.nextFloat() - 0.5f);
+    }
+
+    // Host buffers up to the prepared size, referring to the preallocated one
+    juce::AudioBuffer<float> getBlock(const TapeWarmAudioProcessor& processor, int numSamples)
+    {
+        const int numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        return juce::AudioBuffer<float>(buffer.getArrayOfWritePointers(), numChannels, juce::jmin(numSamples, preparedBlockSize));
+    }
+
+    void checkBlocks(TapeWarmAudioProcessor& processor, const juce::String& context)
+    {
+        const int before = RealtimeChecker::getNumViolations();
+        fillNoise();
+
+        for (int i = 0; i < 2 * numBlockSizes; ++i)
+        {
+            auto view = getBlock(processor, blockSizes[i % numBlockSizes]);
+            processor.processBlock(view, midi);
+        }
+
+        expectEquals(RealtimeChecker::getNumViolations() - before, 0, context);
+    }
+
+    // Every step of the choices and switches, five points across the continuous ranges
+    void sweepParameter(TapeWarmAudioProcessor& processor, juce::RangedAudioParameter& parameter)
+    {
+        const int numSteps = parameter.getNumSteps();
+        const int numValues = (numSteps > 1 && numSteps <= 16) ? numSteps : 5;
+        const float original = parameter.getValue();
+
+        // Quality and anti-aliasing are applied from the processor's timer
+        const bool appliedByTimer = parameter.getParameterID() == "quality" || parameter.getParameterID() == "aliasing";
+
+        for (int step = 0; step < numValues; ++step)
+        {
+            parameter.setValueNotifyingHost(static_cast<float>(step) / static_cast<float>(numValues - 1));
+            if (appliedByTimer)
+                applyMessageThreadChanges();
+            checkBlocks(processor, "with " + parameter.getName(32) + " at " + parameter.getCurrentValueAsText());
+        }
+
+        parameter.setValueNotifyingHost(original);
+        if (appliedByTimer)
+            applyMessageThreadChanges();
+    }
+
+    // Every saturation path: each one the quality and anti-aliasing re-prepare
+    // switches to, for each tape type
+    void sweepPathChanges(TapeWarmAudioProcessor& processor)
+    {
+        auto& apvts = processor.getAPVTS();
+        auto* quality = apvts.getParameter("quality");
+        auto* aliasing = apvts.getParameter("aliasing");
+        auto* tapeType = apvts.getParameter("tapeType");
+
+        for (int q = 0; q < quality->getNumSteps(); ++q)
+            for (int a = 0; a < aliasing->getNumSteps(); ++a)
+                for (int t = 0; t < tapeType->getNumSteps(); ++t)
+                {
+                    quality->setValueNotifyingHost(quality->convertTo0to1(static_cast<float>(q)));
+                    aliasing->setValueNotifyingHost(aliasing->convertTo0to1(static_cast<float>(a)));
+                    tapeType->setValueNotifyingHost(tapeType->convertTo0to1(static_cast<float>(t)));
+                    applyMessageThreadChanges();
+                    checkBlocks(processor, "with quality " + juce::String(q) + ", anti-aliasing "
+                                           + juce::String(a) + ", tape type " + juce::String(t));
+                }
+    }
+
+    // A blocking call made on a realtime thread must count as a violation
+    template <typename Call>
+    void expectSeen(const char* what, Call&& call)
+    {
+        const int before = RealtimeChecker::getNumViolations();
+        {
+            RealtimeChecker::ScopedRealtime realtimeScope;
+            call();
+        }
+        expectGreaterThan(RealtimeChecker::getNumViolations() - before, 0, what);
+    }
+
+    // Runs the message loop long enough for the processor's timer to re-prepare
+    static void applyMessageThreadChanges()
+    {
+        juce::MessageManager::getInstance()->runDispatchLoopUntil(120);
+    }
+};
+
+static RealtimeSweepTests realtimeSweepTests;
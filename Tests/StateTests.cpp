@@ -0,0 +1,128 @@
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+// Session state: the binary format round trip, sessions saved as APVTS XML
+// before it, and streams that are truncated or from a newer version, which
+// must leave the current state as it is
+class StateTests : public juce::UnitTest
+{
+public:
+    StateTests() : juce::UnitTest("Plugin state", "TapeWarm") {}
+
+    void runTest() override
+    {
+        juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+        beginTest("Binary round trip");
+        {
+            TapeWarmAudioProcessor saved;
+            setDistinctValues(saved, 0.3f);
+            saved.getAPVTS().state.setProperty(extraProperty, 42, nullptr);
+            saved.getAPVTS().state.appendChild(juce::ValueTree(extraChild), nullptr);
+
+            juce::MemoryBlock data;
+            saved.getStateInformation(data);
+            expectEquals(static_cast<juce::uint32>(juce::ByteOrder::littleEndianInt(data.getData())),
+                         TapeWarmAudioProcessor::stateMagic);
+
+            TapeWarmAudioProcessor loaded;
+            loaded.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+            expectSameParameters(loaded, saved);
+            expect(static_cast<int>(loaded.getAPVTS().state.getProperty(extraProperty)) == 42);
+            expect(loaded.getAPVTS().state.getChildWithName(extraChild).isValid());
+        }
+
+        beginTest("Legacy XML");
+        {
+            TapeWarmAudioProcessor saved;
+            setDistinctValues(saved, 0.6f);
+
+            // As the plugin saved sessions before the binary format, with a
+            // parameter that has since been removed
+            auto xml = saved.getAPVTS().copyState().createXml();
+            auto* removed = xml->createNewChildElement("PARAM");
+            removed->setAttribute("id", "removedParameter");
+            removed->setAttribute("value", 1.0);
+
+            juce::MemoryBlock data;
+            juce::AudioProcessor::copyXmlToBinary(*xml, data);
+
+            TapeWarmAudioProcessor loaded;
+            loaded.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+            expectSameParameters(loaded, saved);
+        }
+
+        beginTest("Truncated stream keeps the current state");
+        {
+            TapeWarmAudioProcessor saved;
+            setDistinctValues(saved, 0.3f);
+            saved.getAPVTS().state.setProperty(extraProperty, 42, nullptr);
+
+            juce::MemoryBlock data;
+            saved.getStateInformation(data);
+
+            TapeWarmAudioProcessor loaded, expected;
+            setDistinctValues(loaded, 0.8f);
+            setDistinctValues(expected, 0.8f);
+
+            for (size_t size = 0; size < data.getSize(); ++size)
+            {
+                loaded.setStateInformation(data.getData(), static_cast<int>(size));
+                expectSameParameters(loaded, expected, "after " + juce::String(size) + " bytes");
+                expect(! loaded.getAPVTS().state.hasProperty(extraProperty));
+            }
+        }
+
+        beginTest("Newer version keeps the current state");
+        {
+            TapeWarmAudioProcessor saved;
+            setDistinctValues(saved, 0.3f);
+
+            juce::MemoryBlock data;
+            saved.getStateInformation(data);
+
+            // The same stream, marked as written by a later version
+            juce::MemoryOutputStream newer;
+            newer.writeInt(static_cast<int>(TapeWarmAudioProcessor::stateMagic));
+            newer.writeInt(TapeWarmAudioProcessor::stateVersion + 1);
+            newer.write(static_cast<const char*>(data.getData()) + 8, data.getSize() - 8);
+
+            TapeWarmAudioProcessor loaded, expected;
+            setDistinctValues(loaded, 0.8f);
+            setDistinctValues(expected, 0.8f);
+            loaded.setStateInformation(newer.getData(), static_cast<int>(newer.getDataSize()));
+            expectSameParameters(loaded, expected);
+        }
+    }
+
+private:
+    const juce::Identifier extraProperty { "testProperty" };
+    const juce::Identifier extraChild { "TESTCHILD" };
+
+    // Every parameter away from its default, at a step for stepped ones
+    static void setDistinctValues(TapeWarmAudioProcessor& processor, float position)
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            const int numSteps = parameter->getNumSteps();
+            float value = position;
+            if (numSteps > 1 && numSteps <= 16)
+                value = std::round(position * static_cast<float>(numSteps - 1)) / static_cast<float>(numSteps - 1);
+            parameter->setValueNotifyingHost(value);
+        }
+    }
+
+    void expectSameParameters(TapeWarmAudioProcessor& actual, TapeWarmAudioProcessor& expected,
+                              const juce::String& context = {})
+    {
+        const auto& actualParameters = actual.getParameters();
+        const auto& expectedParameters = expected.getParameters();
+        expectEquals(actualParameters.size(), expectedParameters.size());
+
+        for (int i = 0; i < actualParameters.size(); ++i)
+            expectWithinAbsoluteError(actualParameters[i]->getValue(), expectedParameters[i]->getValue(), 1.0e-6f,
+                                      actualParameters[i]->getName(32) + " " + context);
+    }
+};
+
+static StateTests stateTests;
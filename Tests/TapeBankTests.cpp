@@ -0,0 +1,154 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/TapeBank.h"
+#include <cmath>
+#include <vector>
+
+// Each TapeBank lane against a mono TapeProcessor with the same settings, at
+// the Standard tier with wow/flutter off. The processor saturates at 2x and
+// the bank at the base rate, so the input stays low in frequency; what is
+// left is the oversampling filters' ripple, the Type I steps taken from an
+// interpolated input and the two -80 dB hiss floors, which are uncorrelated
+class TapeBankTests : public juce::UnitTest
+{
+public:
+    TapeBankTests() : juce::UnitTest("Tape bank", "TapeWarm") {}
+
+    void runTest() override
+    {
+        for (double sampleRate : { 44100.0, 48000.0 })
+        {
+            beginTest("Lanes match TapeProcessor at " + juce::String(sampleRate) + " Hz");
+
+            constexpr int numChannels = static_cast<int>(std::size(lanes));
+            const int numSamples = static_cast<int>(sampleRate);
+
+            TapeBank bank(numChannels);
+            for (int ch = 0; ch < numChannels; ++ch)
+                configure(bank, ch, lanes[ch]);
+            bank.prepare(sampleRate);
+
+            std::vector<std::vector<float>> bankOutput;
+            for (int ch = 0; ch < numChannels; ++ch)
+                bankOutput.push_back(makeInput(sampleRate, numSamples, ch));
+
+            float* channels[numChannels];
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    channels[ch] = bankOutput[static_cast<size_t>(ch)].data() + start;
+                bank.process(channels, numChannels, std::min(blockSize, numSamples - start));
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto& settings = lanes[ch];
+
+                TapeProcessor processor;
+                configure(processor, settings);
+                processor.prepare(sampleRate, blockSize);
+                const int latency = processor.getLatencySamples();
+
+                // Run on past the end by the latency, so the outputs line up
+                auto input = makeInput(sampleRate, numSamples, ch);
+                input.resize(static_cast<size_t>(numSamples + latency), 0.0f);
+
+                juce::AudioBuffer<float> buffer(1, blockSize);
+                std::vector<float> expected;
+                for (int start = 0; start < static_cast<int>(input.size()); start += blockSize)
+                {
+                    const int length = std::min(blockSize, static_cast<int>(input.size()) - start);
+                    buffer.setSize(1, length, false, false, true);
+                    buffer.copyFrom(0, 0, input.data() + start, length);
+                    processor.process(buffer);
+                    expected.insert(expected.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + length);
+                }
+
+                // The first 100 ms let both settle
+                double error = 0.0, signal = 0.0;
+                for (int i = static_cast<int>(sampleRate * 0.1); i < numSamples; ++i)
+                {
+                    const double reference = expected[static_cast<size_t>(i + latency)];
+                    const double difference = bankOutput[static_cast<size_t>(ch)][static_cast<size_t>(i)] - reference;
+                    error += difference * difference;
+                    signal += reference * reference;
+                }
+
+                const double errorDb = 10.0 * std::log10(error / signal);
+                logMessage(juce::String(settings.name) + ": error " + juce::String(errorDb, 1) + " dB");
+                expectLessThan(errorDb, settings.toleranceDb, settings.name);
+            }
+        }
+    }
+
+private:
+    static constexpr int blockSize = 512;
+
+    struct Lane
+    {
+        const char* name;
+        MachineType machineType;
+        TapeType tapeType;
+        float inputDrive, saturation, warmth, headBump, bumpFreq, outputGain, mix, age, bias;
+        double toleranceDb;         // Error energy relative to the processor's output
+    };
+
+    // One lane per bank curve, and a dry blend and a hot drive
+    static constexpr Lane lanes[] = {
+        { "Linear",          MachineType::IPS_15,  TapeType::TypeII, 0.0f,  0.0f,  50.0f, 60.0f, 80.0f,  0.0f, 100.0f,  0.0f, 50.0f, -60.0 },
+        { "Hysteresis",      MachineType::IPS_7_5, TapeType::TypeI,  0.0f,  50.0f, 70.0f, 80.0f, 60.0f,  0.0f, 100.0f, 30.0f, 50.0f, -55.0 },
+        { "Tanh",            MachineType::IPS_30,  TapeType::TypeII, 3.0f,  70.0f, 30.0f, 40.0f, 120.0f, -2.0f, 100.0f, 0.0f, 60.0f, -60.0 },
+        { "Soft knee",       MachineType::IPS_15,  TapeType::Modern, 6.0f,  90.0f, 50.0f, 50.0f, 100.0f, 0.0f, 100.0f, 60.0f, 40.0f, -60.0 },
+        { "Tanh, 40% mix",   MachineType::IPS_15,  TapeType::TypeII, 0.0f,  50.0f, 50.0f, 50.0f, 80.0f,  3.0f, 40.0f,  0.0f, 50.0f, -60.0 },
+        { "Hysteresis, hot", MachineType::IPS_15,  TapeType::TypeI,  12.0f, 100.0f, 50.0f, 50.0f, 80.0f, -6.0f, 100.0f, 0.0f, 50.0f, -55.0 },
+    };
+
+    static void configure(TapeBank& bank, int ch, const Lane& lane)
+    {
+        bank.setMachineType(ch, static_cast<int>(lane.machineType));
+        bank.setTapeType(ch, static_cast<int>(lane.tapeType));
+        bank.setInputDrive(ch, lane.inputDrive);
+        bank.setSaturation(ch, lane.saturation);
+        bank.setWarmth(ch, lane.warmth);
+        bank.setHeadBump(ch, lane.headBump);
+        bank.setBumpFreq(ch, lane.bumpFreq);
+        bank.setHiss(ch, 0.0f);
+        bank.setOutput(ch, lane.outputGain);
+        bank.setMix(ch, lane.mix);
+        bank.setAge(ch, lane.age);
+        bank.setBias(ch, lane.bias);
+    }
+
+    static void configure(TapeProcessor& processor, const Lane& lane)
+    {
+        processor.setQuality(static_cast<int>(QualityMode::Standard));
+        processor.setMachineType(static_cast<int>(lane.machineType));
+        processor.setTapeType(static_cast<int>(lane.tapeType));
+        processor.setInputDrive(lane.inputDrive);
+        processor.setSaturation(lane.saturation);
+        processor.setWarmth(lane.warmth);
+        processor.setHeadBump(lane.headBump);
+        processor.setBumpFreq(lane.bumpFreq);
+        processor.setWow(0.0f);
+        processor.setFlutter(0.0f);
+        processor.setHiss(0.0f);
+        processor.setOutput(lane.outputGain);
+        processor.setMix(lane.mix);
+        processor.setAge(lane.age);
+        processor.setBias(lane.bias);
+    }
+
+    // Two sines under 1 kHz, different per channel
+    static std::vector<float> makeInput(double sampleRate, int numSamples, int channel)
+    {
+        std::vector<float> input(static_cast<size_t>(numSamples));
+        const double low = juce::MathConstants<double>::twoPi * (110.0 + 20.0 * channel) / sampleRate;
+        const double high = juce::MathConstants<double>::twoPi * (700.0 + 30.0 * channel) / sampleRate;
+
+        for (int i = 0; i < numSamples; ++i)
+            input[static_cast<size_t>(i)] = static_cast<float>(0.3 * std::sin(low * i) + 0.15 * std::sin(high * i));
+
+        return input;
+    }
+};
+
+static TapeBankTests tapeBankTests;
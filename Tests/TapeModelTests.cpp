@@ -0,0 +1,76 @@
+#include <JuceHeader.h>
+#include "../Source/DSP/TapeModel.h"
+
+// The compiled TapeCharacteristics tables, and the shared set built from them
+class TapeModelTests : public juce::UnitTest
+{
+public:
+    TapeModelTests() : juce::UnitTest("Tape characteristics", "TapeWarm") {}
+
+    void runTest() override
+    {
+        using namespace TapeCharacteristics;
+
+        beginTest("Built-in models follow the tables");
+        {
+            for (int m = 0; m < NUM_MACHINE_TYPES; ++m)
+            {
+                for (int t = 0; t < NUM_TAPE_TYPES; ++t)
+                {
+                    for (int q = 0; q < NUM_QUALITY_MODES; ++q)
+                    {
+                        const auto& model = builtInModels.get(static_cast<MachineType>(m), static_cast<TapeType>(t),
+                                                              static_cast<QualityMode>(q));
+
+                        expect(model.machineType == static_cast<MachineType>(m));
+                        expect(model.tapeType == static_cast<TapeType>(t));
+                        expect(model.quality == static_cast<QualityMode>(q));
+
+                        expect(juce::exactlyEqual(model.tapeSpeed, machines[m].tapeSpeed));
+                        expect(juce::exactlyEqual(model.gapWidth, machines[m].gapWidth));
+                        expect(juce::exactlyEqual(model.headSpacing, machines[m].headSpacing));
+                        expect(juce::exactlyEqual(model.driveScale, tapes[t].driveScale));
+                        expect(juce::exactlyEqual(model.coatingThickness, tapes[t].coatingThickness));
+                        expectEquals(model.oversamplingFactor, qualities[q].oversamplingFactor);
+                        expectEquals(model.hysteresisSteps, qualities[q].hysteresisSteps);
+                        expect(model.fastTanh == qualities[q].fastTanh);
+
+                        expectWithinAbsoluteError(model.bumpMaxGainDb, TapeModel::MAX_BUMP_GAIN_DB * tapes[t].bumpGain, 1.0e-6f);
+                    }
+                }
+            }
+        }
+
+        beginTest("Emphasis standards");
+        {
+            // NAB is 3180 + 50 us except at 30 IPS (AES, 17.5 us); IEC has no bass term
+            expectWithinAbsoluteError(getEmphasis(EmphasisMode::NAB, MachineType::IPS_15).lowTimeConstant, 3180.0f, 0.0f);
+            expectWithinAbsoluteError(getEmphasis(EmphasisMode::NAB, MachineType::IPS_15).highTimeConstant, 50.0f, 0.0f);
+            expectWithinAbsoluteError(getEmphasis(EmphasisMode::NAB, MachineType::IPS_30).highTimeConstant, 17.5f, 0.0f);
+            expectWithinAbsoluteError(getEmphasis(EmphasisMode::IEC, MachineType::IPS_7_5).highTimeConstant, 70.0f, 0.0f);
+            expectWithinAbsoluteError(getEmphasis(EmphasisMode::IEC, MachineType::IPS_15).highTimeConstant, 35.0f, 0.0f);
+
+            for (int m = 0; m < NUM_MACHINE_TYPES; ++m)
+                expect(juce::exactlyEqual(getEmphasis(EmphasisMode::IEC, static_cast<MachineType>(m)).lowTimeConstant, 0.0f));
+        }
+
+        beginTest("Shared model set");
+        {
+            const auto first = TapeModelSet::acquire();
+            const auto second = TapeModelSet::acquire();
+            expect(first == second, "instances share one set");
+
+            // Without a profile file the set is the built-in table
+            if (! first->hasProfile())
+            {
+                const auto& shared = first->get(MachineType::IPS_7_5, TapeType::Modern, QualityMode::HQ);
+                const auto& builtIn = builtInModels.get(MachineType::IPS_7_5, TapeType::Modern, QualityMode::HQ);
+                expect(juce::exactlyEqual(shared.bumpSpeedMultiplier, builtIn.bumpSpeedMultiplier));
+                expect(juce::exactlyEqual(shared.bumpMaxGainDb, builtIn.bumpMaxGainDb));
+                expectEquals(shared.oversamplingFactor, builtIn.oversamplingFactor);
+            }
+        }
+    }
+};
+
+static TapeModelTests tapeModelTests;
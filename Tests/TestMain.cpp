@@ -0,0 +1,17 @@
+#include <JuceHeader.h>
+
+// Runs every juce::UnitTest linked in; the exit code is the number of
+// tests with failures, so ctest reports them
+int main()
+{
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runAllTests();
+
+    int numFailed = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        if (runner.getResult(i)->failures > 0)
+            ++numFailed;
+
+    return numFailed;
+}
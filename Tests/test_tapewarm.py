@@ -0,0 +1,122 @@
+"""Smoke test of the tapewarm Python module, run by ctest when it is built
+(TAPEWARM_PYTHON) with the module's directory on PYTHONPATH.
+
+Checks that process() works on the caller's array in place rather than on a
+copy, and that process_batch() gives the same output as processing each clip
+on its own the way the batch does."""
+
+import unittest
+
+import numpy as np
+import tapewarm
+
+SAMPLE_RATE = 48000.0
+BLOCK_SIZE = 512        # OfflineRenderer::BLOCK_SIZE, the batch's processing block
+SEED = 1
+
+SETTINGS = {
+    "machine_type": tapewarm.MachineType.IPS_15,
+    "tape_type": tapewarm.TapeType.TYPE_I,
+    "input_drive": 6.0,
+    "saturation": 70.0,
+    "head_bump": 60.0,
+    "wow": 40.0,
+    "flutter": 30.0,
+    "hiss": 20.0,
+    "mix": 90.0,
+}
+
+
+def make_clip(num_channels, num_samples, seed):
+    rng = np.random.default_rng(seed)
+    t = np.arange(num_samples, dtype=np.float32)
+    channels = [0.5 * np.sin(0.01 * (ch + 1) * t) + 0.1 * rng.standard_normal(num_samples)
+                for ch in range(num_channels)]
+    clip = np.asarray(channels, dtype=np.float32)
+    return clip[0].copy() if num_channels == 1 else clip
+
+
+def data_pointer(array):
+    return array.__array_interface__["data"][0]
+
+
+def create_processor():
+    tape = tapewarm.TapeProcessor()
+    for name, value in SETTINGS.items():
+        getattr(tape, "set_" + name)(value)
+    tape.set_timeline(SEED)
+    tape.prepare(SAMPLE_RATE, BLOCK_SIZE)
+    return tape
+
+
+def process_clip(clip):
+    """What process_batch() does for one clip: whole blocks from a freshly
+    prepared processor, zeros past the end, and the latency trimmed off."""
+    tape = create_processor()
+    latency = tape.latency
+
+    planar = clip.reshape(-1, clip.shape[-1])
+    num_samples = planar.shape[1]
+    num_blocks = -(-(num_samples + latency) // BLOCK_SIZE)
+
+    padded = np.zeros((planar.shape[0], num_blocks * BLOCK_SIZE), dtype=np.float32)
+    padded[:, :num_samples] = planar
+
+    for start in range(0, padded.shape[1], BLOCK_SIZE):
+        tape.process(padded[:, start:start + BLOCK_SIZE])
+
+    return padded[:, latency:latency + num_samples].reshape(clip.shape)
+
+
+class ProcessTests(unittest.TestCase):
+    def test_process_is_in_place(self):
+        tape = create_processor()
+
+        for num_channels in (1, 2):
+            audio = make_clip(num_channels, 4096, seed=num_channels)
+            original = audio.copy()
+            pointer = data_pointer(audio)
+
+            self.assertIsNone(tape.process(audio))
+            self.assertEqual(data_pointer(audio), pointer)
+            self.assertFalse(np.array_equal(audio, original), "process() left the caller's array unchanged")
+            self.assertTrue(np.all(np.isfinite(audio)))
+
+    def test_process_rejects_what_it_cannot_process_in_place(self):
+        tape = create_processor()
+
+        with self.assertRaises(TypeError):
+            tape.process(np.zeros((2, 512), dtype=np.float64))
+
+        read_only = np.zeros((2, 512), dtype=np.float32)
+        read_only.setflags(write=False)
+        with self.assertRaises(ValueError):
+            tape.process(read_only)
+
+
+class ProcessBatchTests(unittest.TestCase):
+    def test_list_of_clips_matches_process(self):
+        clips = [make_clip(2, 20000, seed=1), make_clip(1, 777, seed=2), make_clip(2, 48000, seed=3)]
+        expected = [process_clip(clip) for clip in clips]
+        pointers = [data_pointer(clip) for clip in clips]
+
+        tapewarm.process_batch(clips, SAMPLE_RATE, SETTINGS, num_threads=2, seed=SEED)
+
+        for clip, result, pointer in zip(clips, expected, pointers):
+            self.assertEqual(data_pointer(clip), pointer)
+            np.testing.assert_allclose(clip, result, rtol=0.0, atol=1e-6)
+
+    def test_rows_of_an_array_match_process(self):
+        batch = np.stack([make_clip(2, 10000, seed=seed) for seed in range(4)])
+        expected = [process_clip(row) for row in batch]
+        pointer = data_pointer(batch)
+
+        tapewarm.process_batch(batch, SAMPLE_RATE, SETTINGS, num_threads=0, seed=SEED)
+
+        self.assertEqual(data_pointer(batch), pointer)
+        for row, result in zip(batch, expected):
+            np.testing.assert_allclose(row, result, rtol=0.0, atol=1e-6)
+
+
+if __name__ == "__main__":
+    unittest.main()